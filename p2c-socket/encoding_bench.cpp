@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "json.hpp"
+#include "frame_codec.h"
+
+using json = nlohmann::json;
+
+// 帧编码吞吐基准：同一条状态消息分别用 JSON 文本、MessagePack、CBOR 编码成帧，
+// 再经 FrameReader 切帧并解码，统计每条消息的字节数和每秒往返次数
+// 解码结果必须与原消息相同，否则返回 1
+
+static constexpr int MESSAGES = 200'000;
+
+struct Result {
+    size_t bytes = 0;      // 每帧字节数（含帧头）
+    double perSecond = 0;  // 每秒编码+解码的消息数
+    bool roundTrip = true;
+};
+
+static Result run(const json& message, FrameEncoding encoding) {
+    Result result;
+    for (int round = 0; round < 3; ++round) {
+        FrameReader reader;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < MESSAGES; ++i) {
+            std::string frame = encode_frame(encode_message(message, encoding), encoding);
+            result.bytes = frame.size();
+            size_t available = 0;
+            char* space = reader.prepare(frame.size(), available);
+            std::copy(frame.begin(), frame.end(), space);
+            reader.commit(frame.size());
+            Frame decoded;
+            if (reader.next(decoded) != FrameStatus::Ok || decode_message(decoded) != message) result.roundTrip = false;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.perSecond = std::max(result.perSecond, MESSAGES / seconds);
+    }
+    return result;
+}
+
+int main() {
+    // 与 exe 端上报的状态消息结构相近：坐标、速度、动画名、时间戳和按下的键
+    const json message = {
+        {"type", "telemetry"}, {"x", 1234.5}, {"y", 678.25}, {"vx", -12.5}, {"vy", 3.75},
+        {"anim", "Move"}, {"t", 1700000000123LL}, {"keys", {1, 2, 3, 4, 5, 6, 7, 8}},
+    };
+
+    int failures = 0;
+    printf("%d messages\n", MESSAGES);
+    for (auto encoding : { FrameEncoding::Text, FrameEncoding::MsgPack, FrameEncoding::Cbor }) {
+        Result result = run(message, encoding);
+        printf("%-8s %4zu B/frame %8.0f msg/s%s\n", encoding_name(encoding), result.bytes, result.perSecond,
+            result.roundTrip ? "" : "  MISMATCH");
+        if (!result.roundTrip) ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstring>
+
+#include "frame_codec.h"
+
+static constexpr size_t INITIAL_BUFFER_SIZE = 4096;
+
+char* FrameReader::prepare(size_t minFree, size_t& available) {
+    // 已消费的数据挪走，未消费的移到开头
+    if (begin > 0) {
+        if (begin < end) std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (buffer.size() - end < minFree) {
+        buffer.resize(std::max({ buffer.size() * 2, end + minFree, INITIAL_BUFFER_SIZE }));
+    }
+    available = buffer.size() - end;
+    return buffer.data() + end;
+}
+
+void FrameReader::commit(size_t count) {
+    end += count;
+}
+
+FrameStatus FrameReader::next(Frame& frame) {
+    if (end - begin < FRAME_HEADER_SIZE) return FrameStatus::NeedMore;
+    const auto* header = reinterpret_cast<const unsigned char*>(buffer.data() + begin);
+    if (header[0] > static_cast<uint8_t>(FrameEncoding::Cbor)) return FrameStatus::BadEncoding;
+    uint32_t length = uint32_t(header[1]) << 16 | uint32_t(header[2]) << 8 | header[3];
+    if (length > maxSize) return FrameStatus::TooLarge;
+    if (end - begin - FRAME_HEADER_SIZE < length) return FrameStatus::NeedMore;
+
+    frame.encoding = static_cast<FrameEncoding>(header[0]);
+    frame.payload = std::string_view(buffer.data() + begin + FRAME_HEADER_SIZE, length);
+    begin += FRAME_HEADER_SIZE + length;
+    return FrameStatus::Ok;
+}
+
+std::string encode_frame(std::string_view payload, FrameEncoding encoding) {
+    auto length = static_cast<uint32_t>(payload.size());
+    std::string frame;
+    frame.reserve(FRAME_HEADER_SIZE + payload.size());
+    frame.push_back(static_cast<char>(encoding));
+    frame.push_back(static_cast<char>(length >> 16));
+    frame.push_back(static_cast<char>(length >> 8));
+    frame.push_back(static_cast<char>(length));
+    frame.append(payload);
+    return frame;
+}
+
+std::string encode_message(const nlohmann::json& message, FrameEncoding encoding) {
+    std::string payload;
+    switch (encoding) {
+        case FrameEncoding::MsgPack:
+            nlohmann::json::to_msgpack(message, payload);
+            break;
+        case FrameEncoding::Cbor:
+            nlohmann::json::to_cbor(message, payload);
+            break;
+        default:
+            payload = message.dump();
+    }
+    return payload;
+}
+
+nlohmann::json decode_message(const Frame& frame) {
+    const char* first = frame.payload.data();
+    const char* last = first + frame.payload.size();
+    switch (frame.encoding) {
+        case FrameEncoding::MsgPack:
+            return nlohmann::json::from_msgpack(first, last, true, false);
+        case FrameEncoding::Cbor:
+            return nlohmann::json::from_cbor(first, last, true, false);
+        default:
+            return nlohmann::json::parse(first, last, nullptr, false);
+    }
+}
+
+const char* encoding_name(FrameEncoding encoding) {
+    switch (encoding) {
+        case FrameEncoding::MsgPack: return "msgpack";
+        case FrameEncoding::Cbor: return "cbor";
+        default: return "json";
+    }
+}
+
+bool encoding_from_name(std::string_view name, FrameEncoding& encoding) {
+    for (auto candidate : { FrameEncoding::Text, FrameEncoding::MsgPack, FrameEncoding::Cbor }) {
+        if (name == encoding_name(candidate)) {
+            encoding = candidate;
+            return true;
+        }
+    }
+    return false;
+}
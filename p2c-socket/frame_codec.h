@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.hpp"
+
+// 帧格式：4 字节大端头（高 8 位为编码，低 24 位为长度）+ 消息体
+// TCP 是字节流，一次 recv 可能只收到半条消息，也可能收到好几条，必须按长度切分
+// 编码为 0 的帧与旧格式完全相同，握手前和不支持二进制的对端一律使用文本
+// 本文件不依赖套接字，桌宠的控制端口（spine-eto-cpp）也使用同一份实现
+constexpr size_t FRAME_HEADER_SIZE = 4;
+constexpr uint32_t MAX_FRAME_SIZE = (1u << 24) - 1;
+
+// 帧内消息的编码
+enum class FrameEncoding : uint8_t {
+    Text = 0,    // JSON 文本或普通字符串
+    MsgPack = 1,
+    Cbor = 2,
+};
+
+enum class FrameStatus {
+    Ok,          // 取出了一帧
+    NeedMore,    // 数据不够一帧，继续 recv
+    BadEncoding, // 未知编码，连接已不可信
+    TooLarge,    // 帧长超过接收方的上限，连接已不可信
+};
+
+struct Frame {
+    FrameEncoding encoding = FrameEncoding::Text;
+    std::string_view payload;
+};
+
+// 接收缓冲：收到的数据追加在末尾，完整的帧直接以视图形式交出，不复制
+class FrameReader {
+public:
+    // maxSize 为接收方允许的最大帧长，读到帧头即可判断，不必等整帧到达
+    explicit FrameReader(uint32_t maxSize = MAX_FRAME_SIZE) : maxSize(maxSize) {}
+
+    // 返回至少 minFree 字节的写入位置，available 为实际可写字节数
+    char* prepare(size_t minFree, size_t& available);
+    // recv 写入了 count 字节
+    void commit(size_t count);
+    // 取出下一帧，frame.payload 指向内部缓冲，下一次 prepare 之前有效
+    FrameStatus next(Frame& frame);
+    // 缓冲中尚未消费的字节数
+    size_t buffered() const { return end - begin; }
+
+private:
+    std::vector<char> buffer;
+    size_t begin = 0;
+    size_t end = 0;
+    uint32_t maxSize;
+};
+
+// 在消息前加上帧头，得到可以一次发送的完整帧
+std::string encode_frame(std::string_view payload, FrameEncoding encoding = FrameEncoding::Text);
+
+// JSON 消息与帧内容互转：文本编码用 dump/parse，二进制编码用 MessagePack/CBOR
+std::string encode_message(const nlohmann::json& message, FrameEncoding encoding);
+// 解析失败返回 discarded 值
+nlohmann::json decode_message(const Frame& frame);
+
+// 握手用的编码名（"json"、"msgpack"、"cbor"），未知名称返回 false
+const char* encoding_name(FrameEncoding encoding);
+bool encoding_from_name(std::string_view name, FrameEncoding& encoding);
@@ -0,0 +1,17 @@
+#include <algorithm>
+
+#include "frame_protocol.h"
+
+bool send_all(socket_t s, const char* data, size_t size) {
+    while (size > 0) {
+        int chunk = static_cast<int>(std::min<size_t>(size, 1u << 30));
+        ssize_result sent = send(s, data, chunk, SEND_FLAGS);
+        if (sent < 0) {
+            if (socket_interrupted(socket_last_error())) continue;
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
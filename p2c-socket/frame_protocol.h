@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+#include "frame_codec.h"
+#include "socket_compat.h"
+
+// 发送全部数据（处理部分写入和 EINTR），失败返回 false
+bool send_all(socket_t s, const char* data, size_t size);
@@ -4,7 +4,101 @@ import tkinter as tk
 from tkinter import messagebox
 import subprocess
 import json
+import os
+import struct
 import sys
+from pathlib import Path
+
+
+# 帧头：4 字节大端，高 8 位为编码，低 24 位为长度，与 exe 端 frame_protocol.h 一致
+FRAME_HEADER = struct.Struct(">I")
+MAX_FRAME_SIZE = (1 << 24) - 1
+ENCODING_TEXT, ENCODING_MSGPACK, ENCODING_CBOR = 0, 1, 2
+
+try:
+    import msgpack
+except ImportError:
+    msgpack = None
+try:
+    import cbor2
+except ImportError:
+    cbor2 = None
+
+# 本机可用的编码，握手时按 exe 给出的顺序选第一个
+CODECS = {"json": ENCODING_TEXT}
+if msgpack:
+    CODECS["msgpack"] = ENCODING_MSGPACK
+if cbor2:
+    CODECS["cbor"] = ENCODING_CBOR
+
+
+# exe 端由 CMake 构建（目标 untitled），可用环境变量 P2C_CLIENT 指定路径
+CLIENT_TARGET = "untitled"
+
+
+def find_client_exe():
+    override = os.environ.get("P2C_CLIENT")
+    if override:
+        return Path(override) if Path(override).is_file() else None
+    # 在本目录下的构建目录中查找（含 Debug/Release 子目录），取最近构建的一个
+    here = Path(__file__).resolve().parent
+    names = (CLIENT_TARGET + ".exe", CLIENT_TARGET)
+    candidates = [path for name in names
+                  for pattern in (f"*/{name}", f"*/*/{name}")
+                  for path in here.glob(pattern) if path.is_file()]
+    return max(candidates, key=lambda path: path.stat().st_mtime, default=None)
+
+
+# 界面线程和接收线程都会发送，整帧写完才放行，避免帧交错
+SEND_LOCK = threading.Lock()
+
+
+def send_frame(conn, payload, encoding=ENCODING_TEXT):
+    if isinstance(payload, str):
+        payload = payload.encode()
+    # 长度只有 24 位，超出会写出错误的帧头
+    if len(payload) > MAX_FRAME_SIZE:
+        raise ValueError(f"message too large: {len(payload)} bytes")
+    with SEND_LOCK:
+        conn.sendall(FRAME_HEADER.pack(encoding << 24 | len(payload)) + payload)
+
+
+def send_message(conn, obj, encoding):
+    if encoding == ENCODING_MSGPACK:
+        send_frame(conn, msgpack.packb(obj), encoding)
+    elif encoding == ENCODING_CBOR:
+        send_frame(conn, cbor2.dumps(obj), encoding)
+    else:
+        send_frame(conn, json.dumps(obj))
+
+
+def recv_exact(conn, size):
+    data = bytearray()
+    while len(data) < size:
+        chunk = conn.recv(size - len(data))
+        if not chunk:
+            return None
+        data += chunk
+    return bytes(data)
+
+
+def recv_frame(conn):
+    """返回 (编码, 消息体)，连接断开时返回 None"""
+    header = recv_exact(conn, FRAME_HEADER.size)
+    if header is None:
+        return None
+    (value,) = FRAME_HEADER.unpack(header)
+    encoding, length = value >> 24, value & 0xFFFFFF
+    if encoding not in CODECS.values():
+        raise ValueError(f"unsupported frame encoding: {encoding}")
+    payload = recv_exact(conn, length)
+    return None if payload is None else (encoding, payload)
+
+
+def decode_binary(encoding, payload):
+    if encoding == ENCODING_MSGPACK:
+        return msgpack.unpackb(payload)
+    return cbor2.loads(payload)
 
 
 class ExeManagerGUI:
@@ -16,6 +110,10 @@ class ExeManagerGUI:
         self.addr = None
         self.exe_process = None
         self.is_connected = False
+        self.encoding = ENCODING_TEXT  # 发送 JSON 消息使用的编码，握手后确定
+        # 发给 exe、等待回复的请求：id → 命令名，回复带回同一个 id
+        self.pending = {}
+        self.next_request_id = 1
 
         # 创建Socket服务器
         self.server_socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
@@ -42,7 +140,11 @@ class ExeManagerGUI:
     def start_exe(self):
         if not self.exe_process:
             # 启动 C++ exe
-            self.exe_process = subprocess.Popen(['./client.exe'])
+            exe = find_client_exe()
+            if exe is None:
+                messagebox.showerror("Start Exe", f"找不到 {CLIENT_TARGET}，请先用 CMake 构建或设置 P2C_CLIENT")
+                return
+            self.exe_process = subprocess.Popen([str(exe)])
             print("Exe started with PID:", self.exe_process.pid)
             # 等待 exe 连接到服务器
             self.message_label.config(text="Waiting for exe to connect...")
@@ -53,15 +155,24 @@ class ExeManagerGUI:
             print(f"Connected with {self.addr}")
             self.message_label.config(text=f"Connected to {self.addr}")
             self.is_connected = True
+            self.encoding = ENCODING_TEXT
+            self.pending.clear()
             # 启动接收消息的线程
             threading.Thread(target=self.receive_messages).start()
 
     def receive_messages(self):
         while self.is_connected:
             try:
-                data = self.conn.recv(1024).decode()
-                if not data:
+                frame = recv_frame(self.conn)
+                if frame is None:
                     break  # 如果连接断开，退出循环
+                encoding, payload = frame
+                if encoding != ENCODING_TEXT:
+                    json_data = decode_binary(encoding, payload)
+                    print(f"Received from client: {json_data}")
+                    self.handle_json(json_data)
+                    continue
+                data = payload.decode()
                 print(f"Received from client: {data}")
 
                 try:
@@ -88,40 +199,64 @@ class ExeManagerGUI:
     def send_data_to_exe(self):
         if self.conn:
             data = "Data from GUI: Hello, Exe!"
-            self.conn.send(data.encode())
+            send_frame(self.conn, data)
             print(f"Sent to client: {data}")
         else:
             messagebox.showwarning("Warning", "No connection to send data")
 
     def send_json_to_exe(self):
         if self.conn:
+            request_id = self.next_request_id
+            self.next_request_id += 1
+            self.pending[request_id] = "do_something"
             json_data = {
                 "type": "command",
+                "id": request_id,
                 "command": "do_something",
                 "data": {
                     "param1": "value1",
                     "param2": 123
                 }
             }
-            json_str = json.dumps(json_data)
-            self.conn.send(json_str.encode())
-            print(f"Sent JSON to client: {json_str}")
+            send_message(self.conn, json_data, self.encoding)
+            print(f"Sent JSON to client: {json_data}")
         else:
             messagebox.showwarning("Warning", "No connection to send data")
 
     def handle_json(self, json_data):
-        if json_data.get("type") == "request":
+        if json_data.get("type") == "hello":
+            # 握手：选择双方都支持的编码，回复本身总是文本
+            offered = json_data.get("encodings", [])
+            name = next((e for e in offered if e in CODECS), "json")
+            send_frame(self.conn, json.dumps({"type": "hello", "encoding": name}))
+            self.encoding = CODECS[name]
+            print(f"Negotiated encoding: {name}")
+        elif json_data.get("type") == "response":
+            command = self.pending.pop(json_data.get("id"), None)
+            print(f"Response to {command}: {json_data}")
+        elif json_data.get("type") == "request":
+            request_id = json_data.get("id")
             if json_data.get("request") == "data":
-                self.send_data_to_exe()
+                if request_id is None:
+                    self.send_data_to_exe()
+                else:
+                    # 带 id 的请求单独回复，exe 可以同时发出多个请求
+                    self.reply(request_id, {"data": "Data from GUI: Hello, Exe!"})
             elif json_data.get("request") == "function":
                 function_name = json_data.get("function")
                 print(f"Received request to call function: {function_name}")
                 # 在这里可以调用相应的 Python 函数
+                if request_id is not None:
+                    self.reply(request_id, {"ok": True})
         elif json_data.get("type") == "command":
             command = json_data.get("command")
             print(f"Received command: {command}")
             # 在这里可以处理命令
 
+    def reply(self, request_id, fields):
+        if self.conn:
+            send_message(self.conn, {"type": "response", "id": request_id, **fields}, self.encoding)
+
     def on_closing(self):
         if self.exe_process:
             self.exe_process.terminate()
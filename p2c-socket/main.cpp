@@ -1,64 +1,92 @@
 #include <iostream>
-#include <WS2tcpip.h>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <chrono>
+#include <unordered_map>
+#include <vector>
 #include "json.hpp"
-
-#pragma comment(lib, "Ws2_32.lib")
+#include "frame_protocol.h"
 
 using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+// 请求完成回调，在监听线程中调用；超时或断线时收到 {"ok": false, "error": ...}
+using ResponseCallback = std::function<void(const json& response)>;
 
 class ExeClient {
+public:
+    static constexpr auto DEFAULT_TIMEOUT = std::chrono::seconds(5);
+    static constexpr int RECV_TICK_MS = 100; // 监听线程检查超时的间隔
+    static constexpr size_t MAX_LOG_CHARS = 200;
+
 private:
-    SOCKET connectSocket = 0;
-    bool connected = false;
+    socket_t connectSocket = INVALID_SOCKET_HANDLE;
+    std::atomic<bool> connected = false;
+    std::thread listener;
+    std::mutex sendMutex; // 多个线程同时发送时整帧写完才放行，避免帧交错
+    // JSON 消息的发送编码，握手成功后切换为二进制；接收按每帧帧头中的编码解析
+    std::atomic<FrameEncoding> sendEncoding = FrameEncoding::Text;
+
+    // 等待回复的请求：请求带 "id"，回复带回同一个 "id"，多个请求可同时在途，回复顺序不限
+    struct PendingRequest {
+        ResponseCallback callback;
+        Clock::time_point deadline;
+    };
+    std::mutex pendingMutex;
+    std::unordered_map<uint64_t, PendingRequest> pending;
+    std::atomic<uint64_t> nextRequestId = 1;
 
 public:
     ~ExeClient() {
-        if (connectSocket != 0) {
-            closesocket(connectSocket);
-            WSACleanup();
+        connected = false;
+        if (connectSocket != INVALID_SOCKET_HANDLE) {
+            // 先关闭读写让监听线程从 recv 返回，再回收线程和套接字
+            shutdown(connectSocket, SHUTDOWN_BOTH);
+            if (listener.joinable()) listener.join();
+            socket_close(connectSocket);
+            socket_cleanup();
         }
     }
 
     bool connect_to_server(const std::string& ip, int port) {
-        WSADATA wsaData;
-        int iResult = WSAStartup(MAKEWORD(2, 2), &wsaData);
-        if (iResult != 0) {
-            std::cerr << "WSAStartup failed: " << iResult << std::endl;
+        if (!socket_startup()) {
+            std::cerr << "Socket startup failed: " << socket_last_error() << std::endl;
             return false;
         }
 
         struct addrinfo* result = nullptr;
         struct addrinfo hints{};
-        ZeroMemory(&hints, sizeof(hints));
         hints.ai_family = AF_UNSPEC;
         hints.ai_socktype = SOCK_STREAM;
         hints.ai_protocol = IPPROTO_TCP;
 
-        iResult = getaddrinfo(ip.c_str(), std::to_string(port).c_str(), &hints, &result);
+        int iResult = getaddrinfo(ip.c_str(), std::to_string(port).c_str(), &hints, &result);
         if (iResult != 0) {
             std::cerr << "getaddrinfo failed: " << iResult << std::endl;
-            WSACleanup();
+            socket_cleanup();
             return false;
         }
 
         connectSocket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
-        if (connectSocket == INVALID_SOCKET) {
-            std::cerr << "Socket creation failed: " << WSAGetLastError() << std::endl;
+        if (connectSocket == INVALID_SOCKET_HANDLE) {
+            std::cerr << "Socket creation failed: " << socket_last_error() << std::endl;
             freeaddrinfo(result);
-            WSACleanup();
+            socket_cleanup();
             return false;
         }
 
         iResult = connect(connectSocket, result->ai_addr, (int)result->ai_addrlen);
-        if (iResult == SOCKET_ERROR) {
-            std::cerr << "Connection failed: " << WSAGetLastError() << std::endl;
-            closesocket(connectSocket);
-            connectSocket = INVALID_SOCKET;
+        if (iResult != 0) {
+            std::cerr << "Connection failed: " << socket_last_error() << std::endl;
+            socket_close(connectSocket);
+            connectSocket = INVALID_SOCKET_HANDLE;
             freeaddrinfo(result);
-            WSACleanup();
+            socket_cleanup();
             return false;
         }
 
@@ -67,63 +95,187 @@ public:
         std::cout << "Connected to server!" << std::endl;
 
         // 启动线程监听服务器消息
-        std::thread(&ExeClient::listen_for_commands, this).detach();
+        listener = std::thread(&ExeClient::listen_for_commands, this);
+
+        // 握手：列出支持的编码，服务器选定后回复；旧版服务器不回复，继续使用文本
+        send_frame(json{ {"type", "hello"}, {"encodings", {"msgpack", "cbor", "json"}} }.dump());
 
         return true;
     }
 
-    void send_request_to_gui(const std::string& request) const {
-        if (connected) {
-            send(connectSocket, request.c_str(), request.size(), 0);
+    void send_request_to_gui(const std::string& request) {
+        if (send_frame(request)) {
             std::cout << "Sent to server: " << request << std::endl;
-        } else {
-            std::cerr << "Not connected to server" << std::endl;
         }
     }
 
-    void send_json_request(const json& json_data) const {
-        if (connected) {
-            std::string json_str = json_data.dump();
-            send(connectSocket, json_str.c_str(), json_str.size(), 0);
-            std::cout << "Sent JSON to server: " << json_str << std::endl;
-        } else {
+    void send_json_request(const json& json_data) {
+        FrameEncoding encoding = sendEncoding;
+        if (send_frame(encode_message(json_data, encoding), encoding)) {
+            std::cout << "Sent JSON to server (" << encoding_name(encoding) << "): " << json_data.dump() << std::endl;
+        }
+    }
+
+    // 发送请求并异步等待回复：自动分配 "id"，回复或超时后调用 callback
+    void request_async(json message, ResponseCallback callback, Clock::duration timeout = DEFAULT_TIMEOUT) {
+        uint64_t id = nextRequestId++;
+        message["id"] = id;
+        {
+            std::lock_guard lock(pendingMutex);
+            pending[id] = { std::move(callback), Clock::now() + timeout };
+        }
+        FrameEncoding encoding = sendEncoding;
+        if (!send_frame(encode_message(message, encoding), encoding)) {
+            complete_request(id, { {"ok", false}, {"error", "send failed"} });
+        }
+    }
+
+    // 发送请求，返回回复的 future；可以连续发出多个请求后再逐个等待
+    std::future<json> request(json message, Clock::duration timeout = DEFAULT_TIMEOUT) {
+        auto promise = std::make_shared<std::promise<json>>();
+        std::future<json> future = promise->get_future();
+        request_async(std::move(message), [promise](const json& response) { promise->set_value(response); }, timeout);
+        return future;
+    }
+
+    // 发送一帧，部分写入时继续发送剩余部分
+    bool send_frame(std::string_view payload, FrameEncoding encoding = FrameEncoding::Text) {
+        if (!connected) {
             std::cerr << "Not connected to server" << std::endl;
+            return false;
         }
+        if (payload.size() > MAX_FRAME_SIZE) {
+            std::cerr << "Message too large: " << payload.size() << " bytes" << std::endl;
+            return false;
+        }
+        std::string frame = encode_frame(payload, encoding);
+        std::lock_guard lock(sendMutex);
+        if (!send_all(connectSocket, frame.data(), frame.size())) {
+            std::cerr << "send failed: " << socket_last_error() << std::endl;
+            return false;
+        }
+        return true;
     }
 
     void listen_for_commands() {
-        char buffer[1024];
+        FrameReader reader;
         while (connected) {
-            int recvResult = recv(connectSocket, buffer, 1024, 0);
+            // 先等待可读，超时也定期醒来清理到期的请求
+            int ready = socket_wait_readable(connectSocket, RECV_TICK_MS);
+            if (ready < 0) {
+                int error = socket_last_error();
+                if (socket_interrupted(error)) continue;
+                if (connected) std::cerr << "poll failed: " << error << std::endl;
+                break;
+            }
+            if (ready == 0) {
+                expire_requests(Clock::now());
+                continue;
+            }
+            size_t available = 0;
+            char* space = reader.prepare(4096, available);
+            ssize_result recvResult = recv(connectSocket, space, static_cast<int>(available), 0);
             if (recvResult > 0) {
-                std::string response(buffer, recvResult);
-                std::cout << "Received from server: " << response << std::endl;
-
-                try {
-                    // 尝试解析 JSON
-                    json json_data = json::parse(response);
-                    handle_json(json_data);
-                } catch (json::parse_error& e) {
-                    // 处理非 JSON 消息
-                    std::cout << "Received non-JSON message: " << response << std::endl;
+                reader.commit(static_cast<size_t>(recvResult));
+                // 一次 recv 可能带来多帧，也可能不足一帧
+                Frame frame;
+                FrameStatus status;
+                while ((status = reader.next(frame)) == FrameStatus::Ok) {
+                    handle_frame(frame);
+                }
+                if (status != FrameStatus::NeedMore) {
+                    std::cerr << "Bad frame header, closing connection" << std::endl;
+                    break;
                 }
             } else if (recvResult == 0) {
                 std::cout << "Connection closed by server" << std::endl;
-                connected = false;
-                closesocket(connectSocket);
-                WSACleanup();
                 break;
             } else {
-                std::cerr << "recv failed: " << WSAGetLastError() << std::endl;
-                connected = false;
-                closesocket(connectSocket);
-                WSACleanup();
-                break;
+                int error = socket_last_error();
+                if (!socket_interrupted(error)) {
+                    if (connected) std::cerr << "recv failed: " << error << std::endl;
+                    break;
+                }
             }
+            expire_requests(Clock::now());
+        }
+        // 对端关闭或数据不可信：关闭读写通知对端，套接字由析构函数回收
+        if (connected.exchange(false)) shutdown(connectSocket, SHUTDOWN_BOTH);
+        // 连接已断开，在途请求不会再有回复
+        expire_requests(Clock::time_point::max(), "disconnected");
+    }
+
+    // 取出已到期的请求并以错误完成
+    void expire_requests(Clock::time_point now, const char* error = "timeout") {
+        std::vector<std::pair<uint64_t, ResponseCallback>> expired;
+        {
+            std::lock_guard lock(pendingMutex);
+            for (auto it = pending.begin(); it != pending.end();) {
+                if (it->second.deadline <= now) {
+                    expired.emplace_back(it->first, std::move(it->second.callback));
+                    it = pending.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        for (auto& [id, callback] : expired) {
+            if (callback) callback({ {"id", id}, {"ok", false}, {"error", error} });
+        }
+    }
+
+    // 以 response 完成请求，请求不存在（已超时）时返回 false
+    bool complete_request(uint64_t id, const json& response) {
+        ResponseCallback callback;
+        {
+            std::lock_guard lock(pendingMutex);
+            auto it = pending.find(id);
+            if (it == pending.end()) return false;
+            callback = std::move(it->second.callback);
+            pending.erase(it);
         }
+        // 回调可能再次发出请求，不能持有锁调用
+        if (callback) callback(response);
+        return true;
     }
 
-    static void handle_json(const json& json_data) {
+    void handle_frame(const Frame& frame) {
+        // 直接在接收缓冲上解析，不复制成字符串
+        json json_data = decode_message(frame);
+        if (json_data.is_discarded()) {
+            // 处理非 JSON 消息
+            std::cout << "Received non-JSON message: " << frame.payload << std::endl;
+            return;
+        }
+        // 大消息只打印开头
+        std::string text = json_data.dump();
+        if (text.size() > MAX_LOG_CHARS) text = text.substr(0, MAX_LOG_CHARS) + "... (" + std::to_string(text.size()) + " chars)";
+        std::cout << "Received from server (" << encoding_name(frame.encoding) << "): " << text << std::endl;
+        if (json_data.contains("type") && json_data["type"] == "hello") {
+            handle_hello(json_data);
+            return;
+        }
+        // 带 "id" 且与在途请求对应的是回复，其余为服务器主动发来的消息
+        if (json_data.contains("id") && json_data["id"].is_number_unsigned() &&
+            (!json_data.contains("type") || json_data["type"] == "response") &&
+            complete_request(json_data["id"].get<uint64_t>(), json_data)) {
+            return;
+        }
+        handle_json(json_data);
+    }
+
+    // 服务器选定编码，此后发送的 JSON 消息改用该编码
+    void handle_hello(const json& json_data) {
+        FrameEncoding encoding;
+        if (!json_data.contains("encoding") || !json_data["encoding"].is_string() ||
+            !encoding_from_name(json_data["encoding"].get<std::string>(), encoding)) {
+            return;
+        }
+        sendEncoding = encoding;
+        std::cout << "Negotiated encoding: " << encoding_name(encoding) << std::endl;
+    }
+
+    void handle_json(const json& json_data) {
         if (json_data.contains("type") && json_data["type"] == "command") {
             if (json_data.contains("command")) {
                 std::string command = json_data["command"];
@@ -134,6 +286,10 @@ public:
                     }
                     trigger_function();
                 }
+                // 带 "id" 的命令需要回复，服务器据此匹配
+                if (json_data.contains("id")) {
+                    send_json_request({ {"type", "response"}, {"id", json_data["id"]}, {"ok", command == "do_something"} });
+                }
             }
         }
     }
@@ -162,6 +318,15 @@ int main() {
             {"function", "trigger_function"}
         };
         client.send_json_request(json_data);
+
+        // 流水线请求：一次发出多个请求，不必逐个等待往返
+        std::vector<std::future<json>> replies;
+        for (int i = 0; i < 8; ++i) {
+            replies.push_back(client.request({ {"type", "request"}, {"request", "data"} }));
+        }
+        for (auto& reply : replies) {
+            std::cout << "Reply: " << reply.get().dump() << std::endl;
+        }
     } else {
         std::cerr << "Failed to connect to server" << std::endl;
     }
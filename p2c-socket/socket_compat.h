@@ -0,0 +1,54 @@
+#pragma once
+
+// 套接字跨平台薄封装：Windows 用 Winsock，Linux 用 POSIX 套接字，上层只使用这里的名字
+#ifdef _WIN32
+#include <WS2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+
+using socket_t = SOCKET;
+using ssize_result = int;
+constexpr socket_t INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+
+inline bool socket_startup() {
+    WSADATA wsaData;
+    return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+}
+inline void socket_cleanup() { WSACleanup(); }
+inline int socket_close(socket_t s) { return closesocket(s); }
+inline int socket_last_error() { return WSAGetLastError(); }
+inline bool socket_interrupted(int error) { return error == WSAEINTR; }
+// 等待可读最多 ms 毫秒：>0 可读（或对端关闭、出错，由随后的 recv 给出结果），0 超时，<0 出错
+// 不用 SO_RCVTIMEO：Winsock 中 recv 超时后套接字状态不确定，只能关闭
+inline int socket_wait_readable(socket_t s, int ms) {
+    WSAPOLLFD pfd{ s, POLLRDNORM, 0 };
+    return WSAPoll(&pfd, 1, ms);
+}
+constexpr int SEND_FLAGS = 0;
+constexpr int SHUTDOWN_BOTH = SD_BOTH;
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using socket_t = int;
+using ssize_result = ssize_t;
+constexpr socket_t INVALID_SOCKET_HANDLE = -1;
+
+inline bool socket_startup() { return true; }
+inline void socket_cleanup() {}
+inline int socket_close(socket_t s) { return close(s); }
+inline int socket_last_error() { return errno; }
+inline bool socket_interrupted(int error) { return error == EINTR; }
+// 等待可读最多 ms 毫秒：>0 可读（或对端关闭、出错，由随后的 recv 给出结果），0 超时，<0 出错
+inline int socket_wait_readable(socket_t s, int ms) {
+    pollfd pfd{ s, POLLIN, 0 };
+    return poll(&pfd, 1, ms);
+}
+// 对端关闭后写入不触发 SIGPIPE，改为返回 EPIPE
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+constexpr int SHUTDOWN_BOTH = SHUT_RDWR;
+#endif
@@ -0,0 +1,198 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include "json.hpp"
+#include "frame_protocol.h"
+
+using json = nlohmann::json;
+
+// 本地替身服务器：代替 gui.py 与 exe 端联调分帧逻辑，不需要 Python 和界面
+// 用法：standin_server [端口]（默认 12345），再启动 exe 端
+// 依次发送：分片到达的大帧、一次 send 里的多帧（含 MessagePack）、远大于接收缓冲的超大帧、未知编码的帧
+// 前三项要求 exe 端按 id 回复，最后一项要求 exe 端断开连接；全部满足时返回 0
+
+static constexpr uint64_t SPLIT_ID = 1001, COALESCED_TEXT_ID = 1002, COALESCED_MSGPACK_ID = 1003, OVERSIZED_ID = 1004;
+static constexpr size_t SPLIT_CHUNK = 777;
+static constexpr size_t SPLIT_SIZE = 256 * 1024;
+static constexpr size_t OVERSIZED_SIZE = 4 * 1024 * 1024;
+
+class StandinServer {
+public:
+    explicit StandinServer(socket_t conn) : conn(conn) {}
+
+    void run_reader() {
+        FrameReader reader;
+        while (true) {
+            size_t available = 0;
+            char* space = reader.prepare(4096, available);
+            ssize_result received = recv(conn, space, static_cast<int>(available), 0);
+            if (received < 0 && socket_interrupted(socket_last_error())) continue;
+            if (received <= 0) break;
+            reader.commit(static_cast<size_t>(received));
+            Frame frame;
+            while (reader.next(frame) == FrameStatus::Ok) handle_frame(frame);
+        }
+        std::lock_guard lock(stateMutex);
+        closed = true;
+        stateCv.notify_all();
+    }
+
+    // 发送整帧，超过帧长上限的消息拒绝发送（与 exe 端 send_frame 相同）
+    bool send_message(const std::string& payload, FrameEncoding encoding) {
+        if (payload.size() > MAX_FRAME_SIZE) return false;
+        std::string frame = encode_frame(payload, encoding);
+        std::lock_guard lock(sendMutex);
+        return send_all(conn, frame.data(), frame.size());
+    }
+
+    // 逐段发送同一帧，每段之间稍作停顿，exe 端每次 recv 只能收到一部分
+    bool send_split(const std::string& frame, size_t chunk) {
+        std::lock_guard lock(sendMutex);
+        for (size_t offset = 0; offset < frame.size(); offset += chunk) {
+            if (!send_all(conn, frame.data() + offset, std::min(chunk, frame.size() - offset))) return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return true;
+    }
+
+    bool send_raw(const std::string& bytes) {
+        std::lock_guard lock(sendMutex);
+        return send_all(conn, bytes.data(), bytes.size());
+    }
+
+    bool wait_hello(std::chrono::milliseconds timeout) {
+        std::unique_lock lock(stateMutex);
+        return stateCv.wait_for(lock, timeout, [this] { return helloDone || closed; }) && helloDone;
+    }
+
+    bool wait_replies(const std::set<uint64_t>& ids, std::chrono::milliseconds timeout) {
+        std::unique_lock lock(stateMutex);
+        return stateCv.wait_for(lock, timeout, [&] {
+            if (closed) return true;
+            for (uint64_t id : ids) {
+                if (!replies.contains(id)) return false;
+            }
+            return true;
+        }) && !closed;
+    }
+
+    bool wait_closed(std::chrono::milliseconds timeout) {
+        std::unique_lock lock(stateMutex);
+        return stateCv.wait_for(lock, timeout, [this] { return closed; });
+    }
+
+private:
+    void handle_frame(const Frame& frame) {
+        json message = decode_message(frame);
+        if (message.is_discarded() || !message.is_object()) {
+            std::cout << "Received text: " << frame.payload << std::endl;
+            return;
+        }
+        std::string type = message.contains("type") && message["type"].is_string() ? message["type"].get<std::string>() : "";
+        if (type == "hello") {
+            // 选 exe 端列出的第一个编码，之后 exe 端发来的 JSON 消息改用该编码
+            std::string chosen = "json";
+            if (message.contains("encodings") && message["encodings"].is_array() && !message["encodings"].empty() &&
+                message["encodings"][0].is_string()) {
+                FrameEncoding encoding;
+                if (encoding_from_name(message["encodings"][0].get<std::string>(), encoding)) chosen = encoding_name(encoding);
+            }
+            send_message(json{ {"type", "hello"}, {"encoding", chosen} }.dump(), FrameEncoding::Text);
+            std::cout << "Handshake: " << chosen << std::endl;
+            std::lock_guard lock(stateMutex);
+            helloDone = true;
+            stateCv.notify_all();
+            return;
+        }
+        if (!message.contains("id")) {
+            std::cout << "Received (" << encoding_name(frame.encoding) << "): " << message.dump() << std::endl;
+            return;
+        }
+        if (type == "request") {
+            // exe 端的请求：原样按同一编码回复
+            send_message(encode_message(json{ {"type", "response"}, {"id", message["id"]}, {"data", "standin"} }, frame.encoding),
+                frame.encoding);
+            return;
+        }
+        if (type == "response" && message["id"].is_number_unsigned()) {
+            std::cout << "Reply " << message["id"] << " (" << encoding_name(frame.encoding) << ")" << std::endl;
+            std::lock_guard lock(stateMutex);
+            replies.insert(message["id"].get<uint64_t>());
+            stateCv.notify_all();
+        }
+    }
+
+    socket_t conn;
+    std::mutex sendMutex;
+    std::mutex stateMutex;
+    std::condition_variable stateCv;
+    std::set<uint64_t> replies;
+    bool helloDone = false;
+    bool closed = false;
+};
+
+static json command(uint64_t id, size_t blobSize) {
+    return { {"type", "command"}, {"command", "store"}, {"id", id}, {"blob", std::string(blobSize, 'x')} };
+}
+
+static bool check(bool ok, const char* name) {
+    std::cout << (ok ? "PASS " : "FAIL ") << name << std::endl;
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int port = argc > 1 ? std::atoi(argv[1]) : 12345;
+    if (!socket_startup()) return 1;
+
+    socket_t listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listener, 1) != 0) {
+        std::cerr << "bind/listen failed: " << socket_last_error() << std::endl;
+        return 1;
+    }
+    std::cout << "Stand-in server listening on 127.0.0.1:" << port << std::endl;
+
+    socket_t conn = accept(listener, nullptr, nullptr);
+    socket_close(listener);
+    if (conn == INVALID_SOCKET_HANDLE) return 1;
+
+    StandinServer server(conn);
+    std::thread reader(&StandinServer::run_reader, &server);
+    bool ok = check(server.wait_hello(std::chrono::seconds(5)), "handshake");
+
+    // 分片：一帧拆成几百段到达
+    server.send_split(encode_frame(command(SPLIT_ID, SPLIT_SIZE).dump()), SPLIT_CHUNK);
+    ok &= check(server.wait_replies({ SPLIT_ID }, std::chrono::seconds(5)), "split frame");
+
+    // 粘包：普通字符串、JSON 命令、MessagePack 命令在同一次 send 中
+    server.send_raw(encode_frame("Data from GUI: Hello") + encode_frame(command(COALESCED_TEXT_ID, 16).dump()) +
+        encode_frame(encode_message(command(COALESCED_MSGPACK_ID, 16), FrameEncoding::MsgPack), FrameEncoding::MsgPack));
+    ok &= check(server.wait_replies({ COALESCED_TEXT_ID, COALESCED_MSGPACK_ID }, std::chrono::seconds(5)), "coalesced frames");
+
+    // 超大帧：远大于接收缓冲的初始大小，exe 端需多次 recv 并扩容；超过帧长上限的消息发送端直接拒绝
+    server.send_message(command(OVERSIZED_ID, OVERSIZED_SIZE).dump(), FrameEncoding::Text);
+    ok &= check(server.wait_replies({ OVERSIZED_ID }, std::chrono::seconds(10)), "oversized frame");
+    ok &= check(!server.send_message(std::string(MAX_FRAME_SIZE + 1, 'x'), FrameEncoding::Text), "frame size limit");
+
+    // 未知编码：exe 端应判定连接不可信并断开
+    server.send_raw(std::string("\x7f\x00\x00\x02{}", 6));
+    ok &= check(server.wait_closed(std::chrono::seconds(5)), "unknown encoding closes connection");
+
+    shutdown(conn, SHUTDOWN_BOTH);
+    reader.join();
+    socket_close(conn);
+    socket_cleanup();
+    std::cout << (ok ? "All checks passed" : "Some checks failed") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "spine-eto/key_binding.h"
+#include "spine-eto/vk_code_2_string.h"
+
+// 按键绑定匹配基准：回放随机按键序列，对比转移表自动机与逐条比较历史后缀的朴素实现
+// 两者必须给出相同的命中结果；绑定数从几条增加到几百条时，自动机的单次耗时应保持不变
+
+struct Binding {
+    std::vector<uint32_t> tokens; // 修饰键位 << 8 | VK码
+    std::string pattern;
+};
+
+// 字母表取 8 个键，使随机输入能频繁命中较长的序列
+static const char ALPHABET[] = "ASDFJKLU";
+
+static std::vector<Binding> makeBindings(size_t count, std::mt19937& rng) {
+    std::uniform_int_distribution<int> length(1, 10), key(0, 7), roll(0, 9);
+    std::vector<Binding> bindings;
+    while (bindings.size() < count) {
+        Binding binding;
+        int n = length(rng);
+        for (int i = 0; i < n; ++i) {
+            char c = ALPHABET[key(rng)];
+            bool ctrl = roll(rng) == 0;
+            if (!binding.pattern.empty()) binding.pattern += ' ';
+            if (ctrl) binding.pattern += "Ctrl+";
+            binding.pattern += c;
+            binding.tokens.push_back((ctrl ? VK_MOD_CTRL : 0u) << 8 | static_cast<uint32_t>(c));
+        }
+        bindings.push_back(std::move(binding));
+    }
+    return bindings;
+}
+
+// 朴素实现：保留最近的输入，每次按键逐条检查绑定是否为其后缀，取最长的（同长度取先声明者）
+class NaiveMatcher {
+public:
+    explicit NaiveMatcher(const std::vector<Binding>& bindings) : m_bindings(bindings) {
+        for (const auto& binding : bindings) m_maxLength = std::max(m_maxLength, binding.tokens.size());
+    }
+
+    int feed(uint32_t vk, uint32_t modifiers) {
+        m_history.push_back(modifiers << 8 | vk);
+        if (m_history.size() > m_maxLength) m_history.erase(m_history.begin());
+        int best = -1;
+        size_t bestLength = 0;
+        for (size_t i = 0; i < m_bindings.size(); ++i) {
+            const auto& tokens = m_bindings[i].tokens;
+            if (tokens.size() <= bestLength || tokens.size() > m_history.size()) continue;
+            if (std::equal(tokens.begin(), tokens.end(), m_history.end() - static_cast<ptrdiff_t>(tokens.size()))) {
+                best = static_cast<int>(i);
+                bestLength = tokens.size();
+            }
+        }
+        return best;
+    }
+
+private:
+    const std::vector<Binding>& m_bindings;
+    std::vector<uint32_t> m_history;
+    size_t m_maxLength = 0;
+};
+
+struct Keystroke {
+    uint32_t vk;
+    uint32_t modifiers;
+};
+
+template <typename F>
+static double bestNsPerKey(F&& run, size_t keys, uint64_t& checksum) {
+    double best = 1e30;
+    for (int round = 0; round < 5; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        checksum = run();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns / static_cast<double>(keys));
+    }
+    return best;
+}
+
+int main() {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> key(0, 7), roll(0, 9);
+    std::vector<Keystroke> trace(1'000'000);
+    for (auto& stroke : trace) {
+        stroke.vk = static_cast<uint32_t>(ALPHABET[key(rng)]);
+        stroke.modifiers = roll(rng) == 0 ? VK_MOD_CTRL : 0u;
+    }
+
+    int failures = 0;
+    printf("%zu keys\n", trace.size());
+    for (size_t count : { 2u, 16u, 64u, 256u }) {
+        auto bindings = makeBindings(count, rng);
+        KeyBindingMatcher matcher;
+        // 全部解析成功时动作序号与绑定下标一致
+        for (size_t i = 0; i < bindings.size(); ++i) {
+            if (!matcher.add(bindings[i].pattern, std::to_string(i))) {
+                printf("cannot parse %s\n", bindings[i].pattern.c_str());
+                return 1;
+            }
+        }
+        matcher.build();
+
+        // 间隔 100ms，始终在 SEQUENCE_TIMEOUT_MS 之内，不会触发超时重置
+        uint64_t automatonSum = 0, naiveSum = 0;
+        double automatonNs = bestNsPerKey([&] {
+            matcher.reset();
+            uint64_t sum = 0;
+            uint32_t timeMs = 0;
+            for (const auto& stroke : trace) {
+                int action = matcher.feed(stroke.vk, stroke.modifiers, timeMs += 100);
+                if (action >= 0) sum = sum * 131 + static_cast<uint64_t>(action) + 1;
+            }
+            return sum;
+        }, trace.size(), automatonSum);
+        double naiveNs = bestNsPerKey([&] {
+            NaiveMatcher naive(bindings);
+            uint64_t sum = 0;
+            for (const auto& stroke : trace) {
+                int action = naive.feed(stroke.vk, stroke.modifiers);
+                if (action >= 0) sum = sum * 131 + static_cast<uint64_t>(action) + 1;
+            }
+            return sum;
+        }, trace.size(), naiveSum);
+
+        printf("%4zu bindings: automaton %6.2f ns/key, naive %8.2f ns/key (%.1fx)%s\n", count, automatonNs, naiveNs,
+            naiveNs / automatonNs, automatonSum == naiveSum ? "" : "  MISMATCH");
+        if (automatonSum != naiveSum) ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "spine-eto/key_event_ring.h"
+
+// SpscRing 双线程测试
+// 打字节奏：与 subtitle_window.cpp 相同的 SpscRing<KeyEvent, 1024>，生产者按真实打字和长按自动重复的速率写入，
+//   消费者按帧间隔（偶尔卡顿）读取，检查一个事件都不丢且顺序不变
+// 饱和：生产者持续写入超过容量的序号，消费者边读边偶尔停顿，
+//   检查读到的序号严格递增，且 droppedCount() 恰好等于缺失的序号个数
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+// 打字节奏的各阶段：每秒事件数（按下和抬起各算一个）和持续时间
+struct TypingPhase {
+    const char* name;
+    int eventsPerSecond;
+    std::chrono::milliseconds duration;
+    bool autoRepeat; // 长按：只有按下事件
+};
+
+static int typingCase() {
+    static constexpr TypingPhase PHASES[] = {
+        { "typing", 30, 600ms, false },
+        { "fast typing", 100, 600ms, false },
+        { "auto-repeat", 33, 600ms, true },
+        { "typing", 30, 300ms, false },
+    };
+    static constexpr auto FRAME = 16ms;
+    static constexpr auto HITCH = 250ms; // 偶尔一帧卡顿（加载模型、切换皮肤等）
+
+    SpscRing<KeyEvent, 1024> ring;
+    std::atomic<bool> producerDone{false};
+    uint32_t produced = 0;
+    uint32_t received = 0, disorder = 0, corrupted = 0;
+
+    std::thread consumer([&] {
+        uint32_t expected = 0;
+        int frame = 0;
+        auto drain = [&] {
+            KeyEvent event;
+            while (ring.pop(event)) {
+                // time 字段携带序号，vkCode 由序号推出，用来确认内容完整
+                if (event.time != expected) ++disorder;
+                if (event.vkCode != 'A' + event.time % 26) ++corrupted;
+                expected = event.time + 1;
+                ++received;
+            }
+        };
+        while (!producerDone.load(std::memory_order_acquire)) {
+            drain();
+            std::this_thread::sleep_for(++frame % 40 == 0 ? HITCH : FRAME);
+        }
+        drain();
+    });
+
+    for (const auto& phase : PHASES) {
+        auto interval = std::chrono::duration_cast<Clock::duration>(1s) / phase.eventsPerSecond;
+        auto next = Clock::now();
+        auto end = next + phase.duration;
+        while (next < end) {
+            KeyEvent event;
+            event.time = produced;
+            event.vkCode = 'A' + produced % 26;
+            event.down = phase.autoRepeat || produced % 2 == 0;
+            ring.push(event);
+            ++produced;
+            next += interval;
+            std::this_thread::sleep_until(next);
+        }
+    }
+    producerDone.store(true, std::memory_order_release);
+    consumer.join();
+
+    int failures = 0;
+    printf("typing: produced %u, received %u, dropped %zu\n", produced, received, ring.droppedCount());
+    if (ring.droppedCount() != 0 || received != produced) {
+        printf("FAIL: events were lost at typing rates\n");
+        ++failures;
+    }
+    if (disorder != 0 || corrupted != 0) {
+        printf("FAIL: %u events out of order, %u corrupted\n", disorder, corrupted);
+        ++failures;
+    }
+    return failures;
+}
+
+static constexpr size_t CAPACITY = 64;
+static constexpr uint64_t TOTAL = 500'000;
+
+static int floodCase() {
+    SpscRing<uint64_t, CAPACITY> ring;
+    int failures = 0;
+
+    // 消费者启动前先写满再多写一些，溢出部分必须全部计入丢弃数
+    uint64_t next = 0;
+    for (; next < CAPACITY + 100; ++next) ring.push(next);
+    if (ring.droppedCount() != 100) {
+        printf("FAIL: prefill dropped %zu, expected 100\n", ring.droppedCount());
+        ++failures;
+    }
+    const uint64_t prefillDropped = ring.droppedCount();
+
+    std::atomic<bool> producerDone{false};
+    uint64_t received = 0, gaps = 0, disorder = 0;
+    std::thread consumer([&] {
+        uint64_t expected = 0, value = 0;
+        auto drain = [&] {
+            while (ring.pop(value)) {
+                if (value < expected) ++disorder;
+                else gaps += value - expected;
+                expected = value + 1;
+                // 周期性停顿，让生产者追上并溢出
+                if (++received % 4096 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        };
+        while (!producerDone.load(std::memory_order_acquire)) drain();
+        drain();
+        gaps += TOTAL - expected; // 末尾被丢弃的序号
+    });
+
+    // 生产者按突发写入（每批超过容量），批间让出时间片
+    for (; next < TOTAL; ++next) {
+        ring.push(next);
+        if (next % (CAPACITY * 2) == 0) std::this_thread::yield();
+    }
+    producerDone.store(true, std::memory_order_release);
+    consumer.join();
+
+    // 预填阶段丢弃的序号（CAPACITY..CAPACITY+99）在消费者看来也是缺口
+    size_t dropped = ring.droppedCount();
+    printf("flood: received %llu, dropped %zu (prefill %llu), gaps %llu\n", static_cast<unsigned long long>(received), dropped,
+        static_cast<unsigned long long>(prefillDropped), static_cast<unsigned long long>(gaps));
+    if (disorder != 0) {
+        printf("FAIL: %llu values arrived out of order\n", static_cast<unsigned long long>(disorder));
+        ++failures;
+    }
+    if (received + dropped != TOTAL) {
+        printf("FAIL: received + dropped = %llu, expected %llu\n", static_cast<unsigned long long>(received + dropped),
+            static_cast<unsigned long long>(TOTAL));
+        ++failures;
+    }
+    if (gaps != dropped) {
+        printf("FAIL: %llu values missing but droppedCount() is %zu\n", static_cast<unsigned long long>(gaps), dropped);
+        ++failures;
+    }
+    if (dropped <= prefillDropped) {
+        printf("FAIL: the concurrent flood never overflowed the ring\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int main() {
+    int failures = typingCase();
+    failures += floodCase();
+    return failures == 0 ? 0 : 1;
+}
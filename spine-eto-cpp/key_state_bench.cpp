@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "spine-eto/key_state.h"
+
+// KeyState 与原 std::set<DWORD> 的对比：回放一段模拟打字的按键序列，
+// 每个事件做字幕线程的同一套操作（自动重复判断、增删、复制快照、求新按下的键、检查修饰键、按序遍历）
+
+using DWORD = unsigned long;
+
+struct TraceEvent {
+    uint32_t vk;
+    bool down;
+};
+
+// 模拟打字：字母数字为主，夹杂 Shift/Ctrl 组合和长按自动重复
+static std::vector<TraceEvent> makeTrace(size_t keystrokes) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> letter('A', 'Z'), digit('0', '9'), roll(0, 99);
+    std::vector<TraceEvent> trace;
+    trace.reserve(keystrokes * 3);
+    for (size_t i = 0; i < keystrokes; ++i) {
+        int r = roll(rng);
+        uint32_t modifier = r < 10 ? 0xA0 : r < 15 ? 0xA2 : 0; // VK_LSHIFT / VK_LCONTROL
+        uint32_t vk = static_cast<uint32_t>(r % 4 == 0 ? digit(rng) : letter(rng));
+        if (modifier) trace.push_back({ modifier, true });
+        trace.push_back({ vk, true });
+        if (r >= 97) {
+            for (int repeat = 0; repeat < 8; ++repeat) trace.push_back({ vk, true });
+        }
+        trace.push_back({ vk, false });
+        if (modifier) trace.push_back({ modifier, false });
+    }
+    return trace;
+}
+
+static const uint32_t MODIFIERS[] = { 0x10, 0x11, 0x12, 0x5B, 0x5C, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 };
+
+static uint64_t runKeyState(const std::vector<TraceEvent>& trace) {
+    KeyState modifyMask;
+    for (uint32_t vk : MODIFIERS) modifyMask.set(vk);
+    KeyState pressed, previous;
+    uint64_t checksum = 0;
+    for (const auto& event : trace) {
+        if (!event.down) {
+            pressed.reset(event.vk);
+            continue;
+        }
+        if (pressed.test(event.vk)) continue; // 长按自动重复
+        pressed.set(event.vk);
+        KeyState snapshot = pressed;
+        KeyState fresh = snapshot & ~previous;
+        bool hasModify = !(snapshot & modifyMask).empty();
+        fresh.forEach([&](uint32_t vk) { checksum += vk; });
+        snapshot.forEach([&](uint32_t vk) { checksum = checksum * 31 + vk; });
+        checksum += hasModify;
+        previous = snapshot;
+    }
+    return checksum;
+}
+
+static uint64_t runStdSet(const std::vector<TraceEvent>& trace) {
+    const std::set<DWORD> modifyMask(std::begin(MODIFIERS), std::end(MODIFIERS));
+    std::set<DWORD> pressed, previous;
+    uint64_t checksum = 0;
+    for (const auto& event : trace) {
+        if (!event.down) {
+            pressed.erase(event.vk);
+            continue;
+        }
+        if (pressed.count(event.vk)) continue;
+        pressed.insert(event.vk);
+        std::set<DWORD> snapshot = pressed;
+        std::set<DWORD> fresh;
+        std::set_difference(snapshot.begin(), snapshot.end(), previous.begin(), previous.end(),
+            std::inserter(fresh, fresh.end()));
+        bool hasModify = std::any_of(snapshot.begin(), snapshot.end(), [&](DWORD vk) { return modifyMask.count(vk) > 0; });
+        for (DWORD vk : fresh) checksum += vk;
+        for (DWORD vk : snapshot) checksum = checksum * 31 + vk;
+        checksum += hasModify;
+        previous = snapshot;
+    }
+    return checksum;
+}
+
+template <typename F>
+static double bestNsPerEvent(F&& run, size_t events, uint64_t& checksum) {
+    double best = 1e30;
+    for (int round = 0; round < 5; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        checksum = run();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns / static_cast<double>(events));
+    }
+    return best;
+}
+
+int main() {
+    const auto trace = makeTrace(1'000'000);
+    uint64_t bitsetSum = 0, setSum = 0;
+    double bitsetNs = bestNsPerEvent([&] { return runKeyState(trace); }, trace.size(), bitsetSum);
+    double setNs = bestNsPerEvent([&] { return runStdSet(trace); }, trace.size(), setSum);
+
+    printf("%zu events\n", trace.size());
+    printf("KeyState        %7.2f ns/event\n", bitsetNs);
+    printf("std::set<DWORD> %7.2f ns/event (%.1fx)\n", setNs, setNs / bitsetNs);
+    if (bitsetSum != setSum) {
+        printf("checksum mismatch: %llu vs %llu\n", static_cast<unsigned long long>(bitsetSum),
+            static_cast<unsigned long long>(setSum));
+        return 1;
+    }
+    return 0;
+}
@@ -7,9 +7,15 @@
 #include <sstream>
 
 #include "spine-eto/console_colors.h"
+#include "spine-eto/control_server.h"
+#include "spine-eto/file_watcher.h"
+#include "spine-eto/key_binding.h"
+#include "spine-eto/key_stats.h"
 #include "spine-eto/menu_model_utils.h"
+#include "spine-eto/model_database.h"
 #include "spine-eto/mouse_events.h"
 #include "spine-eto/right_click_menu.h"
+#include "spine-eto/spine_animation.h"
 #include "spine-eto/spine_win_utils.h"
 #include "spine-eto/subtitle_window.h"
 #include "spine-eto/window_physics.h"
@@ -34,13 +40,15 @@ extern bool g_appShouldExit;
 extern bool g_showGlowEffect;
 // 声明全局交互半透明信号变量
 extern bool g_showHalfAlpha;
+// 声明全局动画系统，由 spine_win_utils.cpp 创建
+extern SpineAnimation* animSystem;
 
 // 声明全局字幕特殊处理变量
 bool g_enableSpecialAlpha = false;
 
 // 全局数据库
 nlohmann::json g_initDatabase;
-nlohmann::json g_modelDatabase;
+ModelDatabase g_modelDatabase;
 
 // 解析 #RRGGBB 或 #RRGGBBAA 字符串为 sf::Color
 sf::Color parseHexColor(const std::string& hex) {
@@ -69,6 +77,20 @@ T getOrDefault(const nlohmann::json& j, const char* key, const T& def) {
     return def;
 }
 
+// 读取 json 文件，文件不存在或内容不完整（外部程序写入中途）时返回 false
+static bool readJsonFile(const char* path, nlohmann::json& out) {
+    std::ifstream file(path);
+    if (!file) return false;
+    out = nlohmann::json::parse(file, nullptr, false);
+    return !out.is_discarded();
+}
+
+// 配置项是否在两个版本间发生变化
+static bool configChanged(const nlohmann::json& before, const nlohmann::json& after, const char* key) {
+    bool had = before.contains(key), has = after.contains(key);
+    return had != has || (had && before[key] != after[key]);
+}
+
 int main() {
     system("chcp 65001");
 
@@ -82,14 +104,16 @@ int main() {
         dbFile >> g_initDatabase;
     }
 
-    // 读取 package.json 到全局变量
+    // 读取 package.json 并建立模型库索引
     {
         std::ifstream dbFile("package.json");
         if (!dbFile) {
             std::cout << CONSOLE_BRIGHT_RED << "无法打开 package.json" << CONSOLE_RESET << std::endl;
             return 1;
         }
-        dbFile >> g_modelDatabase;
+        nlohmann::json package;
+        dbFile >> package;
+        g_modelDatabase.load(package);
     }
 
     // 全局窗口和渲染尺寸参数
@@ -111,10 +135,12 @@ int main() {
 
     // 初始化主vk表（如有VK_TABLES配置）
     initVkMainTableFromJson(g_initDatabase);
+    initKeyBindingsFromJson(g_initDatabase);
     g_enableSpecialAlpha = getOrDefault(g_initDatabase, "SPECIAL_KEYS", false);
 
-    // 辉光字符串
+    // 辉光颜色
     std::string GLOW_COLOR = getOrDefault(g_initDatabase, "GLOW_COLOR", std::string("#ffff00"));
+    sf::Color glowColor = parseHexColor(GLOW_COLOR);
 
     int window_width = (420 * 2 + WINDOW_CROP * 30) * G_SCALE;
     int window_height = (420 * 2 + WINDOW_CROP * 30) * G_SCALE;
@@ -126,17 +152,19 @@ int main() {
     MouseEventManager mouseEventManager;
 
     // 物理相关
-    RECT workAreaRect;
-    SystemParametersInfo(SPI_GETWORKAREA, 0, &workAreaRect, 0);
-
     int work_offset = WORK_OFFSET * 10;
 
-    g_workArea.minX = workAreaRect.left;
-    g_workArea.minY = workAreaRect.top;
-    g_workArea.maxX = static_cast<int>(workAreaRect.right - window_width);
-    g_workArea.maxY = static_cast<int>(workAreaRect.bottom - window_height) + y_offset - work_offset;
-    g_workArea.width = window_width;
-    g_workArea.height = window_height;
+    auto updateWorkArea = [&] {
+        RECT workAreaRect;
+        SystemParametersInfo(SPI_GETWORKAREA, 0, &workAreaRect, 0);
+        g_workArea.minX = workAreaRect.left;
+        g_workArea.minY = workAreaRect.top;
+        g_workArea.maxX = static_cast<int>(workAreaRect.right - window_width);
+        g_workArea.maxY = static_cast<int>(workAreaRect.bottom - window_height) + y_offset - work_offset;
+        g_workArea.width = window_width;
+        g_workArea.height = window_height;
+    };
+    updateWorkArea();
 
     // 初始化右键菜单（只初始化一次）
     MenuModel model = getDefaultMenuModel();
@@ -152,6 +180,132 @@ int main() {
     float speed = WALK_SPEED * G_SCALE;
     int gravity = (g_workArea.maxY - g_workArea.minY) * 2 / (GRAVITY_TIME * GRAVITY_TIME);
 
+    // 监视配置文件，外部程序（设置界面）修改后只应用发生变化的部分
+    FileWatcher configWatcher;
+    configWatcher.start(".", { "init.json", "package.json" });
+    std::vector<std::string> changedConfigs;
+
+    auto reloadInitConfig = [&] {
+        nlohmann::json next;
+        if (!readJsonFile("init.json", next) || !next.is_object()) {
+            std::cout << CONSOLE_BRIGHT_YELLOW << "init.json 解析失败，保留当前配置" << CONSOLE_RESET << std::endl;
+            return;
+        }
+        if (configChanged(g_initDatabase, next, "ACTIVE_LEVEL") || configChanged(g_initDatabase, next, "MIX_TIME")) {
+            ACTIVE_LEVEL = getOrDefault(next, "ACTIVE_LEVEL", 2);
+            MIX_TIME = getOrDefault(next, "MIX_TIME", 0.25f);
+            updateSpineSettings(ACTIVE_LEVEL, MIX_TIME);
+        }
+        if (configChanged(g_initDatabase, next, "WALK_SPEED")) {
+            WALK_SPEED = getOrDefault(next, "WALK_SPEED", 100);
+            speed = WALK_SPEED * G_SCALE;
+        }
+        if (configChanged(g_initDatabase, next, "GRAVITY_TIME")) {
+            GRAVITY_TIME = getOrDefault(next, "GRAVITY_TIME", 1.2f);
+            gravity = (g_workArea.maxY - g_workArea.minY) * 2 / (GRAVITY_TIME * GRAVITY_TIME);
+            wakeWindowPhysics();
+        }
+        if (configChanged(g_initDatabase, next, "GLOW_COLOR")) {
+            GLOW_COLOR = getOrDefault(next, "GLOW_COLOR", std::string("#ffff00"));
+            glowColor = parseHexColor(GLOW_COLOR);
+        }
+        if (configChanged(g_initDatabase, next, "SPECIAL_KEYS")) {
+            g_enableSpecialAlpha = getOrDefault(next, "SPECIAL_KEYS", false);
+        }
+        // 窗口尺寸、字幕窗口和按键表在启动时建立，修改后需重启
+        for (const char* key : { "WORK_OFFSET", "WINDOW_CROP", "G_SCALE", "RESIDENCE_TIME", "MAX_SUBTITLES",
+                                 "SUBTITLE_WIDTH", "VK_TABLES", "KEY_BINDINGS", "CONTROL_PORT" }) {
+            if (configChanged(g_initDatabase, next, key)) {
+                std::cout << CONSOLE_BRIGHT_YELLOW << key << " 修改后需重启生效" << CONSOLE_RESET << std::endl;
+            }
+        }
+        g_initDatabase = std::move(next);
+        std::cout << CONSOLE_BRIGHT_GREEN << "已重新加载 init.json" << CONSOLE_RESET << std::endl;
+    };
+
+    auto reloadPackage = [&] {
+        nlohmann::json package;
+        if (!readJsonFile("package.json", package)) {
+            std::cout << CONSOLE_BRIGHT_YELLOW << "package.json 解析失败，保留当前模型库" << CONSOLE_RESET << std::endl;
+            return;
+        }
+        // 菜单列表随模型库版本号在下次弹出时重建
+        if (g_modelDatabase.reload(package)) {
+            reinitSpineModel();
+        }
+        std::cout << CONSOLE_BRIGHT_GREEN << "已重新加载 package.json" << CONSOLE_RESET << std::endl;
+    };
+
+    // 本机控制端口，设置界面等外部程序通过它驱动桌宠（CONTROL_PORT 为 0 时关闭）
+    ControlServer controlServer;
+    int CONTROL_PORT = getOrDefault(g_initDatabase, "CONTROL_PORT", 12346);
+    if (CONTROL_PORT > 0 && CONTROL_PORT < 65536) {
+        controlServer.start(static_cast<uint16_t>(CONTROL_PORT));
+    }
+
+    // 在主线程执行一条控制命令，返回回复内容
+    auto handleControlCommand = [&](const nlohmann::json& request) -> nlohmann::json {
+        auto fail = [](const char* error) { return nlohmann::json{ { "ok", false }, { "error", error } }; };
+        const nlohmann::json done = { { "ok", true } };
+        std::string cmd = getOrDefault(request, "cmd", std::string());
+
+        if (cmd == "state") {
+            nlohmann::json state = {
+                { "ok", true },
+                { "active_level", ACTIVE_LEVEL },
+                { "glow", g_showGlowEffect },
+                { "locked", isPositionLocked() },
+                { "typing_wpm", getTypingWpm() },
+            };
+            if (g_modelDatabase.currentSkinId() != ModelDatabase::INVALID_ID) {
+                state["skin"] = g_modelDatabase.skin(g_modelDatabase.currentSkinId()).name;
+            }
+            if (const ModelRecord* current = g_modelDatabase.currentModel()) state["model"] = current->name;
+            if (animSystem) state["animation"] = animSystem->getCurrentAnimation();
+            return state;
+        }
+        if (cmd == "switch_skin") {
+            std::string skin = getOrDefault(request, "skin", std::string());
+            if (g_modelDatabase.findSkin(skin) == ModelDatabase::INVALID_ID) return fail("unknown skin");
+            g_skinCallback(skin);
+            return done;
+        }
+        if (cmd == "switch_model") {
+            std::string modelName = getOrDefault(request, "model", std::string());
+            uint32_t skinId = g_modelDatabase.currentSkinId();
+            if (skinId == ModelDatabase::INVALID_ID || g_modelDatabase.findModel(skinId, modelName) == ModelDatabase::INVALID_ID) {
+                return fail("unknown model");
+            }
+            g_modelCallback(modelName);
+            return done;
+        }
+        if (cmd == "play") {
+            // 名称不存在时 spine 会断言失败，须先检查
+            std::string anim = getOrDefault(request, "animation", std::string());
+            if (!animSystem || !animSystem->hasAnimation(anim)) return fail("unknown animation");
+            animSystem->playTemp(anim, getOrDefault(request, "loop", false));
+            return done;
+        }
+        if (cmd == "set_active_level") {
+            int level = getOrDefault(request, "level", -1);
+            if (level < 0 || level > 6) return fail("level must be 0-6");
+            ACTIVE_LEVEL = level;
+            updateSpineSettings(ACTIVE_LEVEL, MIX_TIME);
+            return done;
+        }
+        if (cmd == "glow") {
+            g_showGlowEffect = getOrDefault(request, "on", !g_showGlowEffect);
+            return done;
+        }
+        if (cmd == "lock") {
+            setPositionLocked(getOrDefault(request, "on", !isPositionLocked()));
+            return done;
+        }
+        return fail("unknown command");
+    };
+
+    uint32_t bindingCheckedGeneration = g_modelDatabase.generation() - 1;
+
     sf::Clock deltaClock;
     float minFrameTime = 1.0f / 30.0f; // 30 FPS
     while (window.isOpen()) {
@@ -163,6 +317,29 @@ int main() {
             mouseEventManager.handleEvent(event, window);
         }
 
+        // 工作区变化（任务栏移动、分辨率切换）时重算边界并唤醒物理
+        if (consumeWorkAreaChanged()) {
+            updateWorkArea();
+            // 重力按工作区高度换算，下落时间保持 GRAVITY_TIME
+            gravity = (g_workArea.maxY - g_workArea.minY) * 2 / (GRAVITY_TIME * GRAVITY_TIME);
+            wakeWindowPhysics();
+        }
+
+        // 配置文件热加载
+        if (configWatcher.poll(changedConfigs)) {
+            for (const auto& file : changedConfigs) {
+                if (file == "init.json") reloadInitConfig();
+                if (file == "package.json") reloadPackage();
+            }
+        }
+
+        // 外部控制命令（队列有上限，单帧执行的命令数不超过 QUEUE_CAPACITY）
+        controlServer.poll();
+        ControlCommand controlCommand;
+        while (controlServer.popCommand(controlCommand)) {
+            controlServer.reply(controlCommand, handleControlCommand(controlCommand.request));
+        }
+
         // 检查菜单请求退出
         if (g_appShouldExit) {
 
@@ -173,6 +350,8 @@ int main() {
             forceCloseMenuWindow();
             waitMenuThreadExit();
 
+            configWatcher.stop();
+            controlServer.stop();
             window.close();
             break;
         }
@@ -182,6 +361,26 @@ int main() {
         // 持续应用物理效果
         updateWindowPhysics(hwnd, g_windowPhysicsState, g_workArea, speed, gravity, delta);
 
+        // 菜单线程投递的回调（切换皮肤、模型等）
+        runMenuTasks();
+
+        // 模型加载或切换后检查绑定的动画是否存在
+        if (bindingCheckedGeneration != g_modelDatabase.generation() && animSystem) {
+            bindingCheckedGeneration = g_modelDatabase.generation();
+            checkKeyBindingTargets([](const std::string& anim) { return animSystem->hasAnimation(anim); });
+        }
+
+        // 键盘绑定命中的动画（名称不存在时 spine 会断言失败，须先检查）
+        std::string boundAnim;
+        while (pollKeyBindingAction(boundAnim)) {
+            if (!animSystem) continue;
+            if (!animSystem->hasAnimation(boundAnim)) {
+                std::cout << CONSOLE_BRIGHT_YELLOW << "[KEYBIND] 跳过不存在的动画: " << boundAnim << CONSOLE_RESET << std::endl;
+                continue;
+            }
+            animSystem->playTemp(boundAnim);
+        }
+
         // 防止 drawable 为 nullptr 时崩溃
         if (drawable) {
             drawable->update(delta);
@@ -211,7 +410,7 @@ int main() {
             }
             // 再叠加辉光
             if (g_showGlowEffect) {
-                img = addGlowToAlphaEdge(img, parseHexColor(GLOW_COLOR), 4);
+                img = addGlowToAlphaEdge(img, glowColor, 4);
             }
             setClickThrough(hwnd, img);
         } else {
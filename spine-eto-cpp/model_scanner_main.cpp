@@ -0,0 +1,129 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "spine-eto/console_colors.h"
+#include "spine-eto/content_hash.h"
+#include "spine-eto/model_scanner.h"
+
+#include "json.hpp"
+
+namespace fs = std::filesystem;
+
+static const char* USAGE =
+    "用法: model_scanner [models目录] [package.json] [--replace] [--threads N] [--dry-run] [--allow-empty]\n"
+    "  --replace      丢弃 package.json 中未扫描到的条目\n"
+    "  --threads N    校验线程数（默认硬件线程数）\n"
+    "  --dry-run      只扫描和报告，不写入文件\n"
+    "  --allow-empty  没有有效模型时仍然写入（默认拒绝，避免目录写错时清空模型库）\n";
+
+// 模型库扫描工具，增量缓存 scan_cache.json 与 package.json 放在同一目录
+int main(int argc, char** argv) {
+    fs::path modelsDir = "./models";
+    fs::path packagePath = "./package.json";
+    bool replace = false, dryRun = false, allowEmpty = false;
+    unsigned threads = 0;
+
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--replace") == 0) {
+            replace = true;
+        } else if (std::strcmp(argv[i], "--dry-run") == 0) {
+            dryRun = true;
+        } else if (std::strcmp(argv[i], "--allow-empty") == 0) {
+            allowEmpty = true;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strncmp(argv[i], "--", 2) == 0) {
+            // 未知选项（含 --help）不能当成目录
+            printf("%s", USAGE);
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        } else if (positional == 0) {
+            modelsDir = utf8ToPath(argv[i]);
+            ++positional;
+        } else if (positional == 1) {
+            packagePath = utf8ToPath(argv[i]);
+            ++positional;
+        } else {
+            printf("%s", USAGE);
+            return 1;
+        }
+    }
+
+    std::error_code dirError;
+    if (!fs::is_directory(modelsDir, dirError)) {
+        printf(CONSOLE_BRIGHT_RED "[SCAN] 模型目录不存在: %s" CONSOLE_RESET "\n", pathToUtf8(modelsDir).c_str());
+        return 1;
+    }
+
+    fs::path baseDir = packagePath.parent_path().empty() ? fs::path(".") : packagePath.parent_path();
+    fs::path cachePath = baseDir / "scan_cache.json";
+
+    auto start = std::chrono::steady_clock::now();
+    ScanCache cache;
+    loadScanCache(cachePath, cache);
+    ScanReport report = scanModelLibrary(modelsDir, baseDir, cache, threads);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    size_t valid = 0;
+    for (const auto& model : report.models) {
+        if (model.error.empty()) {
+            ++valid;
+            continue;
+        }
+        printf(CONSOLE_BRIGHT_YELLOW "[SCAN] 跳过 %s/%s/%s: %s" CONSOLE_RESET "\n", model.operatorName.c_str(),
+            model.skin.c_str(), model.model.c_str(), model.error.c_str());
+    }
+    printf(CONSOLE_BRIGHT_GREEN "[SCAN] %zu 个模型有效（共 %zu），读取 %zu 个文件，缓存命中 %zu 个，用时 %.1f ms" CONSOLE_RESET "\n",
+        valid, report.models.size(), report.hashedFiles, report.cachedFiles, elapsed.count());
+
+    // 内容相同的文件：桌宠加载时按哈希共享，但磁盘上仍各占一份
+    uint64_t duplicateBytes = 0;
+    for (const auto& group : findDuplicateFiles(report)) {
+        duplicateBytes += group.size * (group.paths.size() - 1);
+        printf(CONSOLE_BRIGHT_CYAN "[SCAN] 重复文件 %s（%llu 字节 × %zu）" CONSOLE_RESET "\n", hashToHex(group.hash).c_str(),
+            static_cast<unsigned long long>(group.size), group.paths.size());
+        for (const auto& path : group.paths) printf("    %s\n", path.c_str());
+    }
+    if (duplicateBytes > 0) {
+        printf(CONSOLE_BRIGHT_CYAN "[SCAN] 重复内容共占用 %.2f MB" CONSOLE_RESET "\n", duplicateBytes / 1048576.0);
+    }
+    if (dryRun) return 0;
+    if (valid == 0 && !allowEmpty) {
+        printf(CONSOLE_BRIGHT_RED "[SCAN] 没有有效模型，未写入（确认要写入空模型库请加 --allow-empty）" CONSOLE_RESET "\n");
+        return 1;
+    }
+
+    nlohmann::json package;
+    if (std::ifstream in(packagePath); in && !replace) {
+        package = nlohmann::json::parse(in, nullptr, false);
+        if (package.is_discarded()) {
+            printf(CONSOLE_BRIGHT_RED "[SCAN] 无法解析 %s，未写入" CONSOLE_RESET "\n", pathToUtf8(packagePath).c_str());
+            return 1;
+        }
+    }
+    mergePackage(package, buildPackageLibrary(report), replace);
+
+    // 先写临时文件再替换，桌宠的文件监视不会读到写了一半的内容
+    fs::path tempPath = packagePath;
+    tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::trunc);
+        if (!out || !(out << package.dump(2))) {
+            printf(CONSOLE_BRIGHT_RED "[SCAN] 写入失败: %s" CONSOLE_RESET "\n", pathToUtf8(tempPath).c_str());
+            return 1;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tempPath, packagePath, ec);
+    if (ec) {
+        printf(CONSOLE_BRIGHT_RED "[SCAN] 写入失败: %s" CONSOLE_RESET "\n", pathToUtf8(packagePath).c_str());
+        return 1;
+    }
+
+    updateScanCache(cache, report);
+    saveScanCache(cachePath, cache);
+    return 0;
+}
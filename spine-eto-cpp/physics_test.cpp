@@ -0,0 +1,53 @@
+#include <cmath>
+#include <cstdio>
+
+#include "spine-eto/physics_step.h"
+
+// 窗口物理测试：以极端速度抛出窗口，逐帧检查位置始终在工作区内、速度不出现 NaN
+// 帧间隔混入 DT_LIMIT（0.25s）模拟卡顿后的大步长
+
+static bool inside(float x, float y, const WindowWorkArea& area) {
+    return !std::isnan(x) && !std::isnan(y) &&
+        x >= static_cast<float>(area.minX) && x <= static_cast<float>(area.maxX) &&
+        y >= static_cast<float>(area.minY) && y <= static_cast<float>(area.maxY);
+}
+
+int main() {
+    const WindowWorkArea areas[] = {
+        { 0, 1500, 0, 800, 420, 280 },
+        { -1920, -400, 40, 1000, 420, 280 }, // 左侧副屏，坐标为负
+        { 100, 100, 300, 300, 420, 280 },    // 工作区比窗口还小，只剩一个点
+    };
+    const float throws[][2] = {
+        { 1e6f, -1e6f }, { -5e5f, 3e5f }, { 2e4f, 2e4f }, { 0.0f, 0.0f },
+        { 300.0f, -4000.0f }, { -1e9f, 0.0f }, { 0.0f, 1e9f }, { 7e7f, -3e8f },
+    };
+    const float gravities[] = { 0.0f, 2000.0f, 1e6f };
+
+    int failures = 0, cases = 0;
+    for (const auto& area : areas) {
+        for (const auto& v : throws) {
+            for (float gravity : gravities) {
+                ++cases;
+                WindowPhysicsState state;
+                state.vx = v[0];
+                state.vy = v[1];
+                float x = static_cast<float>(area.minX + area.maxX) / 2.0f;
+                float y = static_cast<float>(area.minY + area.maxY) / 2.0f;
+                for (int frame = 0; frame < 600; ++frame) {
+                    float dt = frame % 7 == 0 ? 0.25f : 1.0f / 60.0f;
+                    stepWindowPhysics(x, y, state, area, gravity, dt);
+                    if (!inside(x, y, area) || std::isnan(state.vx) || std::isnan(state.vy)) {
+                        printf("FAIL: area [%d,%d]x[%d,%d] v=(%g, %g) g=%g frame %d -> (%g, %g)\n",
+                            area.minX, area.maxX, area.minY, area.maxY, v[0], v[1], gravity, frame, x, y);
+                        ++failures;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%d/%d cases stayed inside the work area\n", cases - failures, cases);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+#include <cstdio>
+#include <string>
+
+#include "spine-eto/pinyin_initial.h"
+
+// 拼音首字母测试：一级、二级汉字各取几个，另外检查整个二级汉字区都能给出 a~z 的首字母
+// 汉字以 GB2312 编码给出，测试不依赖 Win32 的编码转换
+
+struct Sample {
+    const char* name;
+    unsigned short codes[4];
+    const char* initials;
+};
+
+int main() {
+    const Sample samples[] = {
+        { "阿米娅", { 0xB0A2, 0xC3D7, 0xE6AB }, "amy" }, // 娅为二级汉字
+        { "啊座", { 0xB0A1, 0xD7F9 }, "az" },           // 一级汉字首尾
+        { "佤蔻旮", { 0xD8F4, 0xDEA2, 0xEAB8 }, "wkg" },
+        { "鳌黯", { 0xF7A1, 0xF7F6 }, "aa" },           // 二级汉字末行
+    };
+
+    int failures = 0;
+    for (const auto& sample : samples) {
+        std::string initials;
+        for (unsigned short code : sample.codes) {
+            if (code == 0) break;
+            if (char initial = gbPinyinInitial(code)) initials.push_back(initial);
+        }
+        if (initials != sample.initials) {
+            printf("FAIL: %s -> \"%s\", expected \"%s\"\n", sample.name, initials.c_str(), sample.initials);
+            ++failures;
+        }
+    }
+
+    // 非汉字：全角符号、一级汉字区末尾的空位、低字节越界
+    for (unsigned short code : { 0xA1A1, 0xA3C1, 0xD7FA, 0xD8A0, 0xF8A1 }) {
+        if (char initial = gbPinyinInitial(code)) {
+            printf("FAIL: 0x%04X is not a hanzi but got '%c'\n", code, initial);
+            ++failures;
+        }
+    }
+
+    int level2 = 0;
+    for (unsigned hi = 0xD8; hi <= 0xF7; ++hi) {
+        for (unsigned lo = 0xA1; lo <= 0xFE; ++lo) {
+            char initial = gbPinyinInitial(static_cast<unsigned short>(hi << 8 | lo));
+            if (initial >= 'a' && initial <= 'z') {
+                ++level2;
+            } else {
+                printf("FAIL: level-2 code 0x%02X%02X has no initial\n", hi, lo);
+                ++failures;
+            }
+        }
+    }
+
+    printf("%d level-2 hanzi mapped\n", level2);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#include <SFML/Graphics.hpp>
+
+#include <deque>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "asset_store.h"
+#include "console_colors.h"
+#include "content_hash.h"
+
+using namespace spine;
+
+// 引用归零后仍保留的贴图显存预算
+static constexpr size_t RELEASED_TEXTURE_BUDGET = 64u << 20;
+// 保持存活的最近骨骼数据个数（重载当前模型、切回上一个模型时直接复用）
+static constexpr size_t RECENT_SKELETONS = 2;
+
+namespace {
+    struct TextureEntry {
+        sf::Texture* texture = nullptr;
+        int refs = 0;
+        size_t bytes = 0;
+    };
+
+    std::mutex storeMutex;
+    std::unordered_map<uint64_t, TextureEntry> texturesByKey;
+    std::unordered_map<const sf::Texture*, uint64_t> keysByTexture;
+    std::list<uint64_t> releasedTextures; // 引用归零的贴图，最久未用的在前
+    size_t releasedBytes = 0;
+
+    struct SkeletonEntry {
+        std::weak_ptr<Atlas> atlas;
+        std::weak_ptr<SkeletonData> skeletonData;
+    };
+    std::unordered_map<uint64_t, SkeletonEntry> skeletons;
+    std::deque<std::pair<std::shared_ptr<Atlas>, std::shared_ptr<SkeletonData>>> recentSkeletons;
+}
+
+// 超出预算时释放最久未用的贴图（需持有 storeMutex）
+static void trimReleasedTextures() {
+    while (releasedBytes > RELEASED_TEXTURE_BUDGET && !releasedTextures.empty()) {
+        uint64_t key = releasedTextures.front();
+        releasedTextures.pop_front();
+        auto it = texturesByKey.find(key);
+        if (it == texturesByKey.end()) continue;
+        releasedBytes -= it->second.bytes;
+        keysByTexture.erase(it->second.texture);
+        delete it->second.texture;
+        texturesByKey.erase(it);
+    }
+}
+
+class SharedTextureLoader : public TextureLoader {
+public:
+    void load(AtlasPage& page, const String& path) override {
+        std::vector<char> data;
+        if (!readWholeFile(utf8ToPath(path.buffer()), data)) {
+            std::cout << CONSOLE_BRIGHT_RED << "Texture load error: " << path.buffer() << CONSOLE_RESET << std::endl;
+            return;
+        }
+        bool smooth = page.magFilter == TextureFilter_Linear;
+        bool repeated = page.uWrap == TextureWrap_Repeat && page.vWrap == TextureWrap_Repeat;
+        // 采样方式不同的同一张图不能共用纹理对象，一并计入键
+        uint64_t key = contentHash(data.data(), data.size(), (smooth ? 1 : 0) | (repeated ? 2 : 0));
+
+        std::lock_guard lock(storeMutex);
+        auto it = texturesByKey.find(key);
+        if (it != texturesByKey.end()) {
+            if (it->second.refs++ == 0) {
+                releasedTextures.remove(key);
+                releasedBytes -= it->second.bytes;
+            }
+            std::cout << CONSOLE_BRIGHT_CYAN << "Texture reused: " << page.name.buffer() << CONSOLE_RESET << std::endl;
+        } else {
+            auto* texture = new sf::Texture();
+            if (!texture->loadFromMemory(data.data(), data.size())) {
+                delete texture;
+                std::cout << CONSOLE_BRIGHT_RED << "Texture decode error: " << path.buffer() << CONSOLE_RESET << std::endl;
+                return;
+            }
+            texture->setSmooth(smooth);
+            texture->setRepeated(repeated);
+            sf::Vector2u size = texture->getSize();
+            it = texturesByKey.emplace(key, TextureEntry{ texture, 1, static_cast<size_t>(size.x) * size.y * 4 }).first;
+            keysByTexture.emplace(texture, key);
+        }
+
+        page.setRendererObject(it->second.texture);
+        sf::Vector2u size = it->second.texture->getSize();
+        page.width = static_cast<int>(size.x);
+        page.height = static_cast<int>(size.y);
+    }
+
+    void unload(void* texture) override {
+        if (!texture) return;
+        std::lock_guard lock(storeMutex);
+        auto keyIt = keysByTexture.find(static_cast<sf::Texture*>(texture));
+        if (keyIt == keysByTexture.end()) return;
+        auto& entry = texturesByKey[keyIt->second];
+        if (--entry.refs > 0) return;
+        releasedTextures.push_back(keyIt->second);
+        releasedBytes += entry.bytes;
+        trimReleasedTextures();
+    }
+};
+
+TextureLoader* sharedTextureLoader() {
+    static SharedTextureLoader loader;
+    return &loader;
+}
+
+bool findCachedSkeleton(uint64_t key, std::shared_ptr<Atlas>& atlas, std::shared_ptr<SkeletonData>& skeletonData) {
+    std::lock_guard lock(storeMutex);
+    auto it = skeletons.find(key);
+    if (it == skeletons.end()) return false;
+    atlas = it->second.atlas.lock();
+    skeletonData = it->second.skeletonData.lock();
+    if (atlas && skeletonData) return true;
+    skeletons.erase(it);
+    atlas.reset();
+    skeletonData.reset();
+    return false;
+}
+
+void cacheSkeleton(uint64_t key, const std::shared_ptr<Atlas>& atlas, const std::shared_ptr<SkeletonData>& skeletonData) {
+    std::lock_guard lock(storeMutex);
+    skeletons[key] = { atlas, skeletonData };
+    recentSkeletons.emplace_back(atlas, skeletonData);
+    if (recentSkeletons.size() > RECENT_SKELETONS) recentSkeletons.pop_front();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <spine/spine-sfml.h>
+
+#include <cstdint>
+#include <memory>
+
+// 按内容哈希共享的资源仓库：解码前先按字节哈希查找，内容相同的贴图页和骨骼数据只在内存中保留一份
+// 引用归零的贴图暂留在内存预算内，切回刚用过的模型时不必重新解码
+
+// 共享贴图加载器（替代 SFMLTextureLoader，进程内唯一，不需要释放）
+spine::TextureLoader* sharedTextureLoader();
+
+// 骨骼数据缓存：key 由 skel、atlas 内容和 atlas 所在目录的哈希组成
+bool findCachedSkeleton(uint64_t key, std::shared_ptr<spine::Atlas>& atlas, std::shared_ptr<spine::SkeletonData>& skeletonData);
+void cacheSkeleton(uint64_t key, const std::shared_ptr<spine::Atlas>& atlas, const std::shared_ptr<spine::SkeletonData>& skeletonData);
@@ -0,0 +1,116 @@
+#include <cstring>
+#include <fstream>
+
+#include "content_hash.h"
+
+// XXH64 常量
+static constexpr uint64_t PRIME1 = 11400714785074694791ULL;
+static constexpr uint64_t PRIME2 = 14029467366897019727ULL;
+static constexpr uint64_t PRIME3 = 1609587929392839161ULL;
+static constexpr uint64_t PRIME4 = 9650029242287828579ULL;
+static constexpr uint64_t PRIME5 = 2870177450012600261ULL;
+
+static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+static uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * PRIME2;
+    return rotl(acc, 31) * PRIME1;
+}
+
+static uint64_t mergeRound(uint64_t acc, uint64_t val) {
+    acc ^= round64(0, val);
+    return acc * PRIME1 + PRIME4;
+}
+
+uint64_t contentHash(const void* data, size_t size, uint64_t seed) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2, v2 = seed + PRIME2, v3 = seed, v4 = seed - PRIME1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = round64(v1, read64(p));
+            v2 = round64(v2, read64(p + 8));
+            v3 = round64(v3, read64(p + 16));
+            v4 = round64(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + PRIME5;
+    }
+    h += size;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= round64(0, read64(p));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= *p * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool readWholeFile(const std::filesystem::path& path, std::vector<char>& buffer) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    auto size = static_cast<std::streamoff>(file.tellg());
+    if (size < 0) return false;
+    buffer.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(buffer.data(), size));
+}
+
+std::string pathToUtf8(const std::filesystem::path& path) {
+    std::u8string u8 = path.generic_u8string();
+    return { reinterpret_cast<const char*>(u8.data()), u8.size() };
+}
+
+std::filesystem::path utf8ToPath(const std::string& text) {
+    return { std::u8string(reinterpret_cast<const char8_t*>(text.data()), text.size()) };
+}
+
+std::string hashToHex(uint64_t hash) {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i, hash >>= 4) hex[i] = digits[hash & 0xF];
+    return hex;
+}
+
+uint64_t hashFromHex(const std::string& hex) {
+    uint64_t hash = 0;
+    for (char c : hex) {
+        int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+        if (digit < 0) return 0;
+        hash = hash << 4 | static_cast<uint64_t>(digit);
+    }
+    return hash;
+}
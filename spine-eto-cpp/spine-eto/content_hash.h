@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// 内容哈希（XXH64），用于模型库扫描的增量判断和资源去重
+uint64_t contentHash(const void* data, size_t size, uint64_t seed = 0);
+
+// 读取整个文件，失败返回 false
+bool readWholeFile(const std::filesystem::path& path, std::vector<char>& buffer);
+
+// UTF-8 字符串与路径互转（Windows 下 std::string 构造的路径按本地代码页解释，中文路径会出错）
+std::string pathToUtf8(const std::filesystem::path& path);
+std::filesystem::path utf8ToPath(const std::string& text);
+
+// 哈希值的16位十六进制表示（写入缓存文件和报告）
+std::string hashToHex(uint64_t hash);
+uint64_t hashFromHex(const std::string& hex);
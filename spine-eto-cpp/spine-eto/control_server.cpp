@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600 // WSAPoll 需要 Vista 及以上
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "console_colors.h"
+#include "control_server.h"
+
+// 套接字差异集中在这里
+#ifdef _WIN32
+using socket_t = SOCKET;
+static constexpr int SEND_FLAGS = 0;
+static int pollSockets(WSAPOLLFD* fds, size_t count) { return WSAPoll(fds, static_cast<ULONG>(count), 0); }
+using PollFd = WSAPOLLFD;
+static void closeSocket(socket_t s) { closesocket(s); }
+static bool lastErrorWouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+static bool setNonBlocking(socket_t s) {
+    u_long mode = 1;
+    return ioctlsocket(s, FIONBIO, &mode) == 0;
+}
+#else
+using socket_t = int;
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL; // 对端关闭后写入不触发 SIGPIPE
+static int pollSockets(pollfd* fds, size_t count) { return ::poll(fds, count, 0); }
+using PollFd = pollfd;
+static void closeSocket(socket_t s) { close(s); }
+static bool lastErrorWouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+static bool setNonBlocking(socket_t s) {
+    int flags = fcntl(s, F_GETFL, 0);
+    return flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif
+
+static socket_t toSocket(uintptr_t handle) { return static_cast<socket_t>(handle); }
+static uintptr_t toHandle(socket_t s) { return static_cast<uintptr_t>(s); }
+
+static constexpr size_t READ_CHUNK = 4096;
+
+bool ControlServer::start(uint16_t port) {
+    stop();
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) return false;
+#endif
+    m_started = true;
+
+    socket_t s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (toHandle(s) == UINTPTR_MAX) {
+        stop();
+        return false;
+    }
+    m_listenSocket = toHandle(s);
+
+    int option = 1;
+#ifdef _WIN32
+    // 防止其他进程抢占同一端口
+    setsockopt(s, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, reinterpret_cast<const char*>(&option), sizeof(option));
+#else
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+#endif
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // 只接受本机连接
+    if (bind(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(s, static_cast<int>(MAX_CLIENTS)) != 0 || !setNonBlocking(s)) {
+        printf(CONSOLE_BRIGHT_YELLOW "[CONTROL] 无法监听端口 %u" CONSOLE_RESET "\n", port);
+        stop();
+        return false;
+    }
+    printf(CONSOLE_BRIGHT_GREEN "[CONTROL] 控制端口 127.0.0.1:%u" CONSOLE_RESET "\n", port);
+    return true;
+}
+
+void ControlServer::stop() {
+    for (auto& client : m_clients) closeSocket(toSocket(client.socket));
+    m_clients.clear();
+    m_queue.clear();
+    if (m_listenSocket != UINTPTR_MAX) {
+        closeSocket(toSocket(m_listenSocket));
+        m_listenSocket = UINTPTR_MAX;
+    }
+    if (m_started) {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        m_started = false;
+    }
+}
+
+void ControlServer::poll() {
+    if (m_listenSocket == UINTPTR_MAX) return;
+
+    // 上一帧因队列满而留在缓冲中的命令
+    for (auto& client : m_clients) parseFrames(client);
+
+    bool queueOpen = m_queue.size() < QUEUE_CAPACITY;
+    std::vector<PollFd> fds;
+    fds.reserve(m_clients.size() + 1);
+    fds.push_back({ toSocket(m_listenSocket), static_cast<short>(m_clients.size() < MAX_CLIENTS ? POLLIN : 0), 0 });
+    for (const auto& client : m_clients) {
+        short events = 0;
+        if (queueOpen) events |= POLLIN;
+        if (client.outputBegin < client.output.size()) events |= POLLOUT;
+        fds.push_back({ toSocket(client.socket), events, 0 });
+    }
+    if (pollSockets(fds.data(), fds.size()) <= 0) return;
+
+    if (fds[0].revents & POLLIN) acceptClients();
+    for (size_t i = 1; i < fds.size(); ++i) {
+        Client& client = m_clients[i - 1];
+        if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) readClient(client);
+        if (!client.closed && (fds[i].revents & POLLOUT)) flushClient(client);
+    }
+
+    std::erase_if(m_clients, [](const Client& client) {
+        if (client.closed) closeSocket(toSocket(client.socket));
+        return client.closed;
+    });
+}
+
+bool ControlServer::popCommand(ControlCommand& command) {
+    if (m_queue.empty()) return false;
+    command = std::move(m_queue.front());
+    m_queue.pop_front();
+    return true;
+}
+
+void ControlServer::reply(const ControlCommand& command, nlohmann::json response) {
+    auto it = std::find_if(m_clients.begin(), m_clients.end(),
+        [&](const Client& client) { return client.id == command.client; });
+    if (it == m_clients.end() || it->closed) return;
+    if (command.request.contains("id")) response["id"] = command.request["id"];
+    sendFrame(*it, response);
+}
+
+void ControlServer::acceptClients() {
+    while (m_clients.size() < MAX_CLIENTS) {
+        socket_t s = accept(toSocket(m_listenSocket), nullptr, nullptr);
+        if (toHandle(s) == UINTPTR_MAX) return;
+        if (!setNonBlocking(s)) {
+            closeSocket(s);
+            continue;
+        }
+        Client& client = m_clients.emplace_back();
+        client.socket = toHandle(s);
+        client.id = m_nextClientId++;
+        printf(CONSOLE_BRIGHT_CYAN "[CONTROL] 客户端 #%u 已连接" CONSOLE_RESET "\n", client.id);
+    }
+}
+
+void ControlServer::readClient(Client& client) {
+    size_t available = 0;
+    char* space = client.input.prepare(READ_CHUNK, available);
+    auto received = recv(toSocket(client.socket), space, static_cast<int>(available), 0);
+    if (received > 0) {
+        client.input.commit(static_cast<size_t>(received));
+        parseFrames(client);
+        return;
+    }
+    if (received < 0 && lastErrorWouldBlock()) return;
+    printf(CONSOLE_BRIGHT_CYAN "[CONTROL] 客户端 #%u 已断开" CONSOLE_RESET "\n", client.id);
+    client.closed = true;
+}
+
+void ControlServer::parseFrames(Client& client) {
+    while (!client.closed && m_queue.size() < QUEUE_CAPACITY) {
+        Frame frame;
+        FrameStatus status = client.input.next(frame);
+        if (status == FrameStatus::NeedMore) return;
+        if (status != FrameStatus::Ok) {
+            sendFrame(client, { { "ok", false }, { "error", "bad frame header" } });
+            flushClient(client);
+            client.closed = true;
+            return;
+        }
+        nlohmann::json request = decode_message(frame);
+        if (request.is_discarded() || !request.is_object()) {
+            sendFrame(client, { { "ok", false }, { "error", "invalid message" } });
+            continue;
+        }
+        if (request.contains("type") && request["type"] == "hello") {
+            handleHello(client, request);
+            continue;
+        }
+        m_queue.push_back({ client.id, std::move(request) });
+    }
+}
+
+void ControlServer::handleHello(Client& client, const nlohmann::json& request) {
+    // 按客户端给出的顺序选第一个支持的编码，都不支持时保持文本
+    FrameEncoding chosen = FrameEncoding::Text;
+    if (request.contains("encodings") && request["encodings"].is_array()) {
+        for (const auto& name : request["encodings"]) {
+            if (name.is_string() && encoding_from_name(name.get<std::string>(), chosen)) break;
+        }
+    }
+    nlohmann::json response = { { "type", "hello" }, { "ok", true }, { "encoding", encoding_name(chosen) } };
+    if (request.contains("id")) response["id"] = request["id"];
+    // 握手回复仍用文本，此后的回复改用选定的编码
+    client.encoding = FrameEncoding::Text;
+    sendFrame(client, response);
+    client.encoding = chosen;
+}
+
+void ControlServer::flushClient(Client& client) {
+    while (client.outputBegin < client.output.size()) {
+        size_t remaining = client.output.size() - client.outputBegin;
+        auto sent = send(toSocket(client.socket), client.output.data() + client.outputBegin, static_cast<int>(remaining), SEND_FLAGS);
+        if (sent <= 0) {
+            if (sent < 0 && lastErrorWouldBlock()) break;
+            client.closed = true;
+            return;
+        }
+        client.outputBegin += static_cast<size_t>(sent);
+    }
+    if (client.outputBegin == client.output.size()) {
+        client.output.clear();
+        client.outputBegin = 0;
+    }
+}
+
+void ControlServer::sendFrame(Client& client, const nlohmann::json& message) {
+    client.output += encode_frame(encode_message(message, client.encoding), client.encoding);
+    if (client.output.size() - client.outputBegin > MAX_PENDING_OUTPUT) {
+        printf(CONSOLE_BRIGHT_YELLOW "[CONTROL] 客户端 #%u 未读取回复，断开" CONSOLE_RESET "\n", client.id);
+        client.closed = true;
+        return;
+    }
+    flushClient(client);
+}
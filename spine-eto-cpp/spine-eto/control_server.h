@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "frame_codec.h"
+#include "json.hpp"
+
+// 本机控制端口：外部程序（设置界面）连接后发送命令驱动桌宠，无需重启
+// 帧格式与握手和 p2c-socket 相同（共用 frame_codec）：4 字节大端头（高 8 位为编码，低 24 位为长度）+ 消息体
+// 连接默认使用 JSON 文本；客户端发送 {"type":"hello","encodings":[...]}，服务端回复 {"type":"hello","encoding":...}，
+// 此后的回复改用选定的编码
+// 不开线程，主循环每帧调用 poll（WSAPoll/poll，超时为0），解析出的命令进入有界队列由主线程执行
+
+// 待执行的命令
+struct ControlCommand {
+    uint32_t client = 0; // 连接序号，回复时使用
+    nlohmann::json request;
+};
+
+class ControlServer {
+public:
+    static constexpr size_t MAX_CLIENTS = 8;
+    static constexpr size_t QUEUE_CAPACITY = 64;        // 队列满时暂停读取，数据留在内核缓冲中形成背压
+    static constexpr uint32_t MAX_REQUEST_SIZE = 1u << 20; // 命令帧的长度上限，小于协议上限
+    static constexpr size_t MAX_PENDING_OUTPUT = 4u << 20; // 对端长期不读时断开
+
+    ControlServer() = default;
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+    ~ControlServer() { stop(); }
+
+    // 监听 127.0.0.1:port，失败返回 false
+    bool start(uint16_t port);
+    void stop();
+
+    // 接受连接、收发数据并解析命令，不阻塞
+    void poll();
+
+    // 取出一条待执行的命令
+    bool popCommand(ControlCommand& command);
+
+    // 回复命令（带回请求中的 id，写入发送缓冲并尽量立即发出），连接已断开时忽略
+    void reply(const ControlCommand& command, nlohmann::json response);
+
+private:
+    struct Client {
+        uintptr_t socket = UINTPTR_MAX;
+        uint32_t id = 0;
+        FrameReader input{ MAX_REQUEST_SIZE };
+        std::string output;
+        size_t outputBegin = 0;
+        FrameEncoding encoding = FrameEncoding::Text; // 回复使用的编码
+        bool closed = false;
+    };
+
+    // 平台套接字句柄：Windows 为 SOCKET，Linux 为文件描述符，统一存为 uintptr_t
+    uintptr_t m_listenSocket = UINTPTR_MAX;
+    bool m_started = false;
+    uint32_t m_nextClientId = 1;
+    std::vector<Client> m_clients;
+    std::deque<ControlCommand> m_queue;
+
+    void acceptClients();
+    void readClient(Client& client);
+    void parseFrames(Client& client);
+    void flushClient(Client& client);
+    void handleHello(Client& client, const nlohmann::json& request);
+    void sendFrame(Client& client, const nlohmann::json& message);
+};
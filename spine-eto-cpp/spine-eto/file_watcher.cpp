@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "console_colors.h"
+#include "file_watcher.h"
+
+static uint64_t nowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void FileWatcher::notifyChanged(const std::string& fileName) {
+    if (std::find(m_fileNames.begin(), m_fileNames.end(), fileName) == m_fileNames.end()) return;
+    std::lock_guard lock(m_mutex);
+    m_pending[fileName] = nowMs();
+}
+
+bool FileWatcher::poll(std::vector<std::string>& changed) {
+    changed.clear();
+    std::lock_guard lock(m_mutex);
+    if (m_pending.empty()) return false;
+    uint64_t now = nowMs();
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (now - it->second >= DEBOUNCE_MS) {
+            changed.push_back(it->first);
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return !changed.empty();
+}
+
+#ifdef _WIN32
+
+bool FileWatcher::start(const std::string& directory, const std::vector<std::string>& fileNames) {
+    stop();
+    m_directory = directory;
+    m_fileNames = fileNames;
+
+    std::wstring wdir(directory.begin(), directory.end());
+    HANDLE dir = CreateFileW(wdir.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (dir == INVALID_HANDLE_VALUE) {
+        printf(CONSOLE_BRIGHT_YELLOW "[WATCH] 无法监视目录: %s" CONSOLE_RESET "\n", directory.c_str());
+        return false;
+    }
+    m_dirHandle = dir;
+    m_stopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    m_running = true;
+    m_thread = std::thread(&FileWatcher::threadFunc, this);
+    return true;
+}
+
+void FileWatcher::stop() {
+    if (!m_running.exchange(false)) return;
+    SetEvent(m_stopEvent);
+    if (m_thread.joinable()) m_thread.join();
+    CloseHandle(m_dirHandle);
+    CloseHandle(m_stopEvent);
+    m_dirHandle = nullptr;
+    m_stopEvent = nullptr;
+}
+
+void FileWatcher::threadFunc() {
+    alignas(DWORD) char buffer[16 * 1024];
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    HANDLE waits[2] = { overlapped.hEvent, m_stopEvent };
+    // 覆盖写入和"写临时文件再改名"两种保存方式
+    constexpr DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+
+    while (m_running) {
+        ResetEvent(overlapped.hEvent);
+        if (!ReadDirectoryChangesW(m_dirHandle, buffer, sizeof(buffer), FALSE, filter, nullptr, &overlapped, nullptr)) break;
+        if (WaitForMultipleObjects(2, waits, FALSE, INFINITE) != WAIT_OBJECT_0) {
+            CancelIoEx(m_dirHandle, &overlapped);
+            DWORD ignored = 0;
+            GetOverlappedResult(m_dirHandle, &overlapped, &ignored, TRUE);
+            break;
+        }
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(m_dirHandle, &overlapped, &bytes, FALSE)) break;
+        // 缓冲区溢出时通知为空，保守地认为所有文件都变了
+        if (bytes == 0) {
+            for (const auto& name : m_fileNames) notifyChanged(name);
+            continue;
+        }
+
+        for (DWORD offset = 0;;) {
+            auto* info = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(buffer + offset);
+            int wlen = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+            int len = WideCharToMultiByte(CP_UTF8, 0, info->FileName, wlen, nullptr, 0, nullptr, nullptr);
+            std::string name(static_cast<size_t>(len), '\0');
+            WideCharToMultiByte(CP_UTF8, 0, info->FileName, wlen, name.data(), len, nullptr, nullptr);
+            if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME) notifyChanged(name);
+            if (info->NextEntryOffset == 0) break;
+            offset += info->NextEntryOffset;
+        }
+    }
+    CloseHandle(overlapped.hEvent);
+}
+
+#else
+
+bool FileWatcher::start(const std::string& directory, const std::vector<std::string>& fileNames) {
+    stop();
+    m_directory = directory;
+    m_fileNames = fileNames;
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0 || inotify_add_watch(m_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0 ||
+        pipe(m_wakePipe) != 0) {
+        printf(CONSOLE_BRIGHT_YELLOW "[WATCH] 无法监视目录: %s" CONSOLE_RESET "\n", directory.c_str());
+        if (m_inotifyFd >= 0) close(m_inotifyFd);
+        m_inotifyFd = -1;
+        return false;
+    }
+    m_running = true;
+    m_thread = std::thread(&FileWatcher::threadFunc, this);
+    return true;
+}
+
+void FileWatcher::stop() {
+    if (!m_running.exchange(false)) return;
+    char wake = 0;
+    (void)write(m_wakePipe[1], &wake, 1);
+    if (m_thread.joinable()) m_thread.join();
+    close(m_inotifyFd);
+    close(m_wakePipe[0]);
+    close(m_wakePipe[1]);
+    m_inotifyFd = -1;
+    m_wakePipe[0] = m_wakePipe[1] = -1;
+}
+
+void FileWatcher::threadFunc() {
+    alignas(inotify_event) char buffer[16 * 1024];
+    pollfd fds[2] = { { m_inotifyFd, POLLIN, 0 }, { m_wakePipe[0], POLLIN, 0 } };
+
+    while (m_running) {
+        if (::poll(fds, 2, -1) < 0 || (fds[1].revents & POLLIN)) break;
+        ssize_t bytes = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (bytes <= 0) continue;
+        for (ssize_t offset = 0; offset < bytes;) {
+            auto* event = reinterpret_cast<inotify_event*>(buffer + offset);
+            if (event->mask & IN_Q_OVERFLOW) {
+                for (const auto& name : m_fileNames) notifyChanged(name);
+            } else if (event->len > 0) {
+                notifyChanged(event->name);
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 监视目录下指定文件的变化（Windows 用 ReadDirectoryChangesW，Linux 用 inotify）
+// 后台线程阻塞等待系统通知，主线程每帧调用 poll 取出已稳定的变化
+class FileWatcher {
+public:
+    static constexpr uint32_t DEBOUNCE_MS = 200; // 最后一次变化后等待的时间（编辑器保存常分多次写入）
+
+    FileWatcher() = default;
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    ~FileWatcher() { stop(); }
+
+    // 开始监视 directory 下的 fileNames，失败返回 false
+    bool start(const std::string& directory, const std::vector<std::string>& fileNames);
+    void stop();
+
+    // 取出防抖期已过的变化文件名，没有时返回 false
+    bool poll(std::vector<std::string>& changed);
+
+private:
+    std::string m_directory;
+    std::vector<std::string> m_fileNames;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, uint64_t> m_pending; // 文件名 → 最后一次变化时间
+
+    // 平台句柄：Windows 为目录句柄和停止事件，Linux 为 inotify 和唤醒管道
+    void* m_dirHandle = nullptr;
+    void* m_stopEvent = nullptr;
+    int m_inotifyFd = -1;
+    int m_wakePipe[2] = { -1, -1 };
+
+    void threadFunc();
+    void notifyChanged(const std::string& fileName);
+};
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "console_colors.h"
+#include "icon_atlas.h"
+
+// 读取整个文件（仅支持 Windows，用 _wfopen 以支持中文路径）
+static bool readIconFile(const std::string& path, std::vector<char>& buffer) {
+    std::wstring wpath = sf::String::fromUtf8(path.begin(), path.end()).toWideString();
+    FILE* fp = _wfopen(wpath.c_str(), L"rb");
+    if (!fp) return false;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    bool ok = size > 0;
+    if (ok) {
+        buffer.resize(static_cast<size_t>(size));
+        ok = fread(buffer.data(), 1, buffer.size(), fp) == buffer.size();
+    }
+    fclose(fp);
+    return ok;
+}
+
+// 按面积平均缩放到 size×size（颜色按alpha加权，透明边缘不发黑）
+static void downsampleIcon(const sf::Image& src, unsigned size, std::vector<sf::Uint8>& out) {
+    sf::Vector2u srcSize = src.getSize();
+    out.assign(static_cast<size_t>(size) * size * 4, 0);
+    const sf::Uint8* pixels = src.getPixelsPtr();
+    float scaleX = static_cast<float>(srcSize.x) / size;
+    float scaleY = static_cast<float>(srcSize.y) / size;
+
+    for (unsigned y = 0; y < size; ++y) {
+        unsigned y0 = static_cast<unsigned>(y * scaleY);
+        unsigned y1 = std::max(y0 + 1, std::min(srcSize.y, static_cast<unsigned>((y + 1) * scaleY)));
+        for (unsigned x = 0; x < size; ++x) {
+            unsigned x0 = static_cast<unsigned>(x * scaleX);
+            unsigned x1 = std::max(x0 + 1, std::min(srcSize.x, static_cast<unsigned>((x + 1) * scaleX)));
+
+            float r = 0.f, g = 0.f, b = 0.f, a = 0.f;
+            for (unsigned sy = y0; sy < y1; ++sy) {
+                const sf::Uint8* p = pixels + (static_cast<size_t>(sy) * srcSize.x + x0) * 4;
+                for (unsigned sx = x0; sx < x1; ++sx, p += 4) {
+                    float alpha = p[3];
+                    r += p[0] * alpha;
+                    g += p[1] * alpha;
+                    b += p[2] * alpha;
+                    a += alpha;
+                }
+            }
+            auto count = static_cast<float>((y1 - y0) * (x1 - x0));
+            sf::Uint8* dst = out.data() + (static_cast<size_t>(y) * size + x) * 4;
+            if (a > 0.f) {
+                dst[0] = static_cast<sf::Uint8>(r / a + 0.5f);
+                dst[1] = static_cast<sf::Uint8>(g / a + 0.5f);
+                dst[2] = static_cast<sf::Uint8>(b / a + 0.5f);
+            }
+            dst[3] = static_cast<sf::Uint8>(a / count + 0.5f);
+        }
+    }
+}
+
+bool IconAtlas::reserveCell() {
+    constexpr unsigned columns = ATLAS_WIDTH / CELL_SIZE;
+    if (m_used < m_rows * columns) return true;
+
+    unsigned newRows = m_rows == 0 ? INITIAL_ROWS : m_rows * 2;
+    if (newRows * CELL_SIZE > sf::Texture::getMaximumSize()) return false;
+
+    // 扩容：新纹理清零后拷入旧内容（GPU内拷贝，不回读）
+    sf::Texture grown;
+    if (!grown.create(ATLAS_WIDTH, newRows * CELL_SIZE)) return false;
+    std::vector<sf::Uint8> blank(static_cast<size_t>(ATLAS_WIDTH) * newRows * CELL_SIZE * 4, 0);
+    grown.update(blank.data());
+    if (m_rows > 0) grown.update(m_texture, 0, 0);
+    m_texture.swap(grown);
+    m_rows = newRows;
+    return true;
+}
+
+sf::IntRect IconAtlas::lookup(const std::string& path) {
+    auto it = m_rects.find(path);
+    if (it != m_rects.end()) return it->second;
+
+    std::vector<sf::Uint8> pixels;
+    std::vector<char> buffer;
+    sf::Image img;
+    if (readIconFile(path, buffer) && img.loadFromMemory(buffer.data(), buffer.size())) {
+        downsampleIcon(img, ICON_SIZE, pixels);
+    } else {
+        printf(CONSOLE_BRIGHT_YELLOW "[ICON] 图标读取失败: %s" CONSOLE_RESET "\n", path.c_str());
+        pixels.assign(static_cast<size_t>(ICON_SIZE) * ICON_SIZE * 4, 0);
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            pixels[i] = 255;
+            pixels[i + 3] = 255;
+        }
+    }
+
+    // 图集已满时返回空矩形，调用方跳过绘制（失败结果同样缓存，不反复读盘）
+    sf::IntRect rect;
+    if (reserveCell()) {
+        constexpr unsigned columns = ATLAS_WIDTH / CELL_SIZE;
+        unsigned left = (m_used % columns) * CELL_SIZE + 1;
+        unsigned top = (m_used / columns) * CELL_SIZE + 1;
+        m_texture.update(pixels.data(), ICON_SIZE, ICON_SIZE, left, top);
+        ++m_used;
+        rect = { static_cast<int>(left), static_cast<int>(top), static_cast<int>(ICON_SIZE), static_cast<int>(ICON_SIZE) };
+    }
+    m_rects.emplace(path, rect);
+    return rect;
+}
+
+IconAtlas& iconAtlas() {
+    static IconAtlas atlas;
+    return atlas;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <unordered_map>
+
+// 菜单图标图集：每个图标只解码一次，缩放到绘制尺寸后打包进同一张纹理
+// 进程内共享，刷新子菜单重建控件时不再重复读盘解码
+// 纹理只能在菜单线程（持有GL上下文的线程）使用
+class IconAtlas {
+public:
+    static constexpr unsigned ICON_SIZE = 24;     // 图标绘制尺寸
+    static constexpr unsigned CELL_SIZE = 26;     // 图集格子尺寸（四周留1像素防止采样串色）
+    static constexpr unsigned ATLAS_WIDTH = 416;  // 每行16格
+    static constexpr unsigned INITIAL_ROWS = 4;   // 初始行数，不够时按行数翻倍扩容
+
+    // 返回图标在图集中的纹理矩形，首次请求时读取并打包（读取失败时为红色占位图）
+    sf::IntRect lookup(const std::string& path);
+
+    [[nodiscard]] const sf::Texture& texture() const { return m_texture; }
+
+private:
+    sf::Texture m_texture;
+    std::unordered_map<std::string, sf::IntRect> m_rects;
+    unsigned m_rows = 0;
+    unsigned m_used = 0;
+
+    // 确保至少还有一个空格子
+    bool reserveCell();
+};
+
+// 进程级图标图集
+IconAtlas& iconAtlas();
@@ -0,0 +1,156 @@
+#include <cstdio>
+#include <map>
+#include <queue>
+#include <string_view>
+
+#include "console_colors.h"
+#include "key_binding.h"
+#include "key_event_ring.h"
+#include "vk_code_2_string.h"
+
+// 修饰键前缀
+static constexpr std::pair<std::string_view, uint32_t> kModifierPrefixes[] = {
+    {"Ctrl+", VK_MOD_CTRL}, {"Alt+", VK_MOD_ALT}, {"Shift+", VK_MOD_SHIFT}, {"Win+", VK_MOD_WIN},
+};
+
+// 解析单个按键项（如 "Ctrl+Shift+S"），失败返回 -1
+static int parseKeyToken(std::string_view text) {
+    uint32_t modifiers = 0;
+    bool matched = true;
+    while (matched) {
+        matched = false;
+        for (const auto& [prefix, bit] : kModifierPrefixes) {
+            if (text.size() > prefix.size() && text.substr(0, prefix.size()) == prefix) {
+                modifiers |= bit;
+                text.remove_prefix(prefix.size());
+                matched = true;
+            }
+        }
+    }
+    int vk = vkCodeFromString(text);
+    // 修饰键本身不作为输入符号
+    if (vk < 0 || modifyVkTables().contains(vk)) return -1;
+    return static_cast<int>(modifiers << 8) | vk;
+}
+
+bool KeyBindingMatcher::add(const std::string& pattern, const std::string& action) {
+    std::vector<uint16_t> symbols;
+    std::string_view rest = pattern;
+    while (!rest.empty()) {
+        size_t space = rest.find(' ');
+        std::string_view item = rest.substr(0, space);
+        rest = space == std::string_view::npos ? std::string_view{} : rest.substr(space + 1);
+        if (item.empty()) continue;
+
+        int token = parseKeyToken(item);
+        if (token < 0) return false;
+        uint16_t& symbol = m_symbolOf[token];
+        if (symbol == 0) symbol = static_cast<uint16_t>(m_symbolCount++);
+        symbols.push_back(symbol);
+    }
+    if (symbols.empty()) return false;
+
+    m_patterns.push_back(std::move(symbols));
+    m_patternActions.push_back(static_cast<int>(m_actions.size()));
+    m_actions.push_back(action);
+    return true;
+}
+
+void KeyBindingMatcher::build() {
+    // 字典树（同一序列重复绑定时保留先声明者）
+    std::vector<std::map<uint16_t, uint32_t>> children(1);
+    std::vector<int> terminal(1, -1);
+    for (size_t i = 0; i < m_patterns.size(); ++i) {
+        uint32_t node = 0;
+        for (uint16_t symbol : m_patterns[i]) {
+            auto it = children[node].find(symbol);
+            if (it == children[node].end()) {
+                it = children[node].emplace(symbol, static_cast<uint32_t>(children.size())).first;
+                children.emplace_back();
+                terminal.push_back(-1);
+            }
+            node = it->second;
+        }
+        if (terminal[node] < 0) terminal[node] = m_patternActions[i];
+    }
+
+    // 按层遍历计算失败链接，并展开为完整转移表
+    auto states = static_cast<uint32_t>(children.size());
+    m_delta.assign(static_cast<size_t>(states) * m_symbolCount, 0);
+    m_output.assign(states, -1);
+    std::vector<uint32_t> fail(states, 0);
+    std::queue<uint32_t> bfs;
+    for (const auto& [symbol, child] : children[0]) {
+        m_delta[symbol] = child;
+        bfs.push(child);
+    }
+    while (!bfs.empty()) {
+        uint32_t u = bfs.front();
+        bfs.pop();
+        // 自身不是终点时继承失败链接上最长的匹配
+        m_output[u] = terminal[u] >= 0 ? terminal[u] : m_output[fail[u]];
+        for (uint32_t symbol = 0; symbol < m_symbolCount; ++symbol) {
+            uint32_t fallback = m_delta[static_cast<size_t>(fail[u]) * m_symbolCount + symbol];
+            auto it = children[u].find(static_cast<uint16_t>(symbol));
+            if (it != children[u].end()) {
+                fail[it->second] = fallback;
+                m_delta[static_cast<size_t>(u) * m_symbolCount + symbol] = it->second;
+                bfs.push(it->second);
+            } else {
+                m_delta[static_cast<size_t>(u) * m_symbolCount + symbol] = fallback;
+            }
+        }
+    }
+    m_patterns.clear();
+    m_patternActions.clear();
+    m_state = 0;
+}
+
+int KeyBindingMatcher::feed(uint32_t vk, uint32_t modifiers, uint32_t timeMs) {
+    if (m_delta.empty()) return -1;
+    // 序列中断太久则从头匹配
+    if (timeMs - m_lastMs > SEQUENCE_TIMEOUT_MS) m_state = 0;
+    m_lastMs = timeMs;
+
+    uint32_t token = modifiers << 8 | vk;
+    uint16_t symbol = token < TOKEN_COUNT ? m_symbolOf[token] : 0;
+    m_state = m_delta[static_cast<size_t>(m_state) * m_symbolCount + symbol];
+    return m_output[m_state];
+}
+
+// 全局绑定（启动时构建，之后只读）
+static KeyBindingMatcher g_keyBindings;
+
+// 字幕线程 → 主线程的命中动作队列
+static SpscRing<uint16_t, 64> g_bindingActions;
+
+void initKeyBindingsFromJson(const nlohmann::json& config) {
+    if (!config.contains("KEY_BINDINGS") || !config["KEY_BINDINGS"].is_object()) return;
+    for (const auto& [pattern, action] : config["KEY_BINDINGS"].items()) {
+        if (!action.is_string() || !g_keyBindings.add(pattern, action.get<std::string>())) {
+            printf(CONSOLE_BRIGHT_YELLOW "[KEYBIND] 无法解析按键绑定: %s" CONSOLE_RESET "\n", pattern.c_str());
+        }
+    }
+    g_keyBindings.build();
+}
+
+void checkKeyBindingTargets(const std::function<bool(const std::string&)>& hasAnimation) {
+    for (const auto& action : g_keyBindings.actions()) {
+        if (!hasAnimation(action)) {
+            printf(CONSOLE_BRIGHT_YELLOW "[KEYBIND] 当前模型没有动画 %s，该绑定将被忽略" CONSOLE_RESET "\n", action.c_str());
+        }
+    }
+}
+
+void feedKeyBindings(uint32_t vk, uint32_t timeMs, const KeyState& pressed) {
+    if (g_keyBindings.empty() || modifyVkTables().contains(static_cast<int>(vk))) return;
+    int action = g_keyBindings.feed(vk, vkModifierBits(pressed), timeMs);
+    if (action >= 0) g_bindingActions.push(static_cast<uint16_t>(action));
+}
+
+bool pollKeyBindingAction(std::string& anim) {
+    uint16_t action;
+    if (!g_bindingActions.pop(action)) return false;
+    anim = g_keyBindings.action(action);
+    return true;
+}
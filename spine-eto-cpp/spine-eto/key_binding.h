@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+#include "key_state.h"
+
+// 按键绑定匹配器：组合键和按键序列统一编译为一个确定性自动机（Aho-Corasick + 完整转移表）
+// 每个按键事件只做一次查表，与绑定数量无关
+class KeyBindingMatcher {
+public:
+    static constexpr uint32_t SEQUENCE_TIMEOUT_MS = 1500; // 序列中两次按键的最大间隔
+
+    // 添加绑定，pattern 为空格分隔的按键序列，每项可带修饰键前缀，如 "Ctrl+S"、"Up Up Down Down B A"
+    // 无法解析时返回 false
+    bool add(const std::string& pattern, const std::string& action);
+
+    // 根据已添加的绑定生成转移表
+    void build();
+
+    // 输入一次非修饰键按下，命中时返回动作序号，否则返回 -1
+    int feed(uint32_t vk, uint32_t modifiers, uint32_t timeMs);
+
+    void reset() { m_state = 0; }
+
+    [[nodiscard]] bool empty() const { return m_actions.empty(); }
+    [[nodiscard]] const std::string& action(int index) const { return m_actions[index]; }
+    [[nodiscard]] const std::vector<std::string>& actions() const { return m_actions; }
+
+private:
+    // 输入符号：修饰键组合位 << 8 | VK码
+    static constexpr uint32_t TOKEN_COUNT = 16 * 256;
+
+    std::vector<std::vector<uint16_t>> m_patterns; // 已转为符号序号的序列
+    std::vector<int> m_patternActions;
+    std::vector<std::string> m_actions;
+
+    std::vector<uint16_t> m_symbolOf = std::vector<uint16_t>(TOKEN_COUNT, 0); // 0 表示未出现在任何绑定中
+    uint32_t m_symbolCount = 1;
+
+    std::vector<uint32_t> m_delta;  // 状态 × 符号 → 状态
+    std::vector<int> m_output;      // 状态 → 动作序号（-1 表示无）
+    uint32_t m_state = 0;
+    uint32_t m_lastMs = 0;
+};
+
+// 从 init.json 的 KEY_BINDINGS 读取绑定（{"Ctrl+S": "Interact", ...}），main.cpp只需调用一次
+void initKeyBindingsFromJson(const nlohmann::json& config);
+
+// 检查绑定的动画在当前模型中是否存在，缺失的打印提示（模型加载或切换后调用）
+void checkKeyBindingTargets(const std::function<bool(const std::string&)>& hasAnimation);
+
+// 字幕线程：输入一次新按下的键（pressed 为按下后的完整按键集合）
+void feedKeyBindings(uint32_t vk, uint32_t timeMs, const KeyState& pressed);
+
+// 主线程：取出一个待播放的绑定动画
+bool pollKeyBindingAction(std::string& anim);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 锁定键状态位
+constexpr uint8_t KEY_LOCK_CAPS = 1;
+constexpr uint8_t KEY_LOCK_NUM = 2;
+constexpr uint8_t KEY_LOCK_SCROLL = 4;
+
+// 键盘事件（钩子线程产生，字幕线程消费）
+struct KeyEvent {
+    uint32_t vkCode = 0;
+    uint32_t time = 0;      // KBDLLHOOKSTRUCT::time，毫秒
+    bool down = false;
+    uint8_t lockBits = 0;   // 锁定键按下后的切换状态，仅锁定键按下事件有效
+};
+
+// 单生产者单消费者无锁环形队列（push/pop 均为 wait-free，容量须为2的幂）
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // 仅生产者线程调用，队列满时丢弃并计数
+    bool push(const T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tailCache == Capacity) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head - m_tailCache == Capacity) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        m_buffer[head & (Capacity - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅消费者线程调用，队列空时返回 false
+    bool pop(T& out) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_headCache) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail == m_headCache) return false;
+        }
+        out = m_buffer[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅消费者线程调用，丢弃所有未处理事件
+    void clear() {
+        T discard;
+        while (pop(discard)) {}
+    }
+
+    [[nodiscard]] size_t droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // 生产者与消费者各自的索引分属不同缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> m_head{0};
+    size_t m_tailCache = 0;
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t m_headCache = 0;
+    alignas(64) std::atomic<size_t> m_dropped{0};
+    std::array<T, Capacity> m_buffer{};
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// 256位按键状态集合（按VK码索引），替代 std::set<DWORD>，集合运算均为字运算
+struct KeyState {
+    std::array<uint64_t, 4> words{};
+
+    static constexpr KeyState single(uint32_t vk) {
+        KeyState s;
+        s.set(vk);
+        return s;
+    }
+
+    constexpr void set(uint32_t vk) {
+        if (vk < 256) words[vk >> 6] |= uint64_t{1} << (vk & 63);
+    }
+    constexpr void reset(uint32_t vk) {
+        if (vk < 256) words[vk >> 6] &= ~(uint64_t{1} << (vk & 63));
+    }
+    [[nodiscard]] constexpr bool test(uint32_t vk) const {
+        return vk < 256 && (words[vk >> 6] >> (vk & 63)) & 1;
+    }
+    constexpr void clear() { words = {}; }
+
+    [[nodiscard]] constexpr bool empty() const {
+        return (words[0] | words[1] | words[2] | words[3]) == 0;
+    }
+    [[nodiscard]] constexpr int count() const {
+        return std::popcount(words[0]) + std::popcount(words[1]) + std::popcount(words[2]) + std::popcount(words[3]);
+    }
+    // 最小的VK码（集合为空时返回256）
+    [[nodiscard]] constexpr uint32_t first() const {
+        for (uint32_t i = 0; i < 4; ++i) {
+            if (words[i]) return i * 64 + static_cast<uint32_t>(std::countr_zero(words[i]));
+        }
+        return 256;
+    }
+
+    // 按VK码升序遍历（与 std::set 的遍历顺序一致）
+    template <typename F>
+    constexpr void forEach(F&& f) const {
+        for (uint32_t i = 0; i < 4; ++i) {
+            for (uint64_t w = words[i]; w; w &= w - 1) {
+                f(i * 64 + static_cast<uint32_t>(std::countr_zero(w)));
+            }
+        }
+    }
+
+    constexpr KeyState operator&(const KeyState& o) const {
+        return {{words[0] & o.words[0], words[1] & o.words[1], words[2] & o.words[2], words[3] & o.words[3]}};
+    }
+    constexpr KeyState operator|(const KeyState& o) const {
+        return {{words[0] | o.words[0], words[1] | o.words[1], words[2] | o.words[2], words[3] | o.words[3]}};
+    }
+    constexpr KeyState operator^(const KeyState& o) const {
+        return {{words[0] ^ o.words[0], words[1] ^ o.words[1], words[2] ^ o.words[2], words[3] ^ o.words[3]}};
+    }
+    constexpr KeyState operator~() const {
+        return {{~words[0], ~words[1], ~words[2], ~words[3]}};
+    }
+    constexpr KeyState& operator&=(const KeyState& o) { return *this = *this & o; }
+    constexpr KeyState& operator|=(const KeyState& o) { return *this = *this | o; }
+    constexpr bool operator==(const KeyState& o) const = default;
+};
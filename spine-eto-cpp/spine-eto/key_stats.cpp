@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <windows.h>
+
+#include "key_stats.h"
+#include "vk_code_2_string.h"
+
+// 统计文件格式：魔数 + 按键次数 + 间隔直方图 + 非零组合键条目（索引u16 + 次数u32）
+static constexpr uint32_t KEY_STATS_MAGIC = 0x3154534B; // "KST1"
+
+// 最近一次更新的WPM及其时间（字幕线程写，其它线程读）
+static std::atomic<float> g_liveWpm{0.f};
+static std::atomic<uint32_t> g_liveWpmTime{0};
+
+// 计入打字速度的按键：字母、数字、符号、空格
+static bool isTypingKey(uint32_t vk) {
+    constexpr uint32_t typingMask = VK_CAT_ALPHABET | VK_CAT_MAIN_NUM | VK_CAT_LITE_NUM | VK_CAT_INTER;
+    return vk == VK_SPACE || (vkCategory(static_cast<int>(vk)) & typingMask);
+}
+
+void KeyStats::onKeyDown(uint32_t vk, uint32_t timeMs, const KeyState& pressed) {
+    if (vk >= 256) return;
+
+    ++m_vkCounts[vk];
+
+    // 修饰键本身只计按键次数
+    uint32_t mods = vkModifierBits(pressed);
+    bool isModifier = modifyVkTables().contains(static_cast<int>(vk));
+    if (!isModifier) ++m_comboCounts[mods * 256 + vk];
+
+    // 按键间隔（无符号差值，兼容 GetTickCount 回绕）
+    if (m_hasLastDown) {
+        uint32_t interval = timeMs - m_lastDownMs;
+        if (interval < INTERVAL_PAUSE_MS) {
+            uint32_t bucket = std::min<uint32_t>(interval / INTERVAL_BUCKET_MS, INTERVAL_BUCKETS - 1);
+            ++m_intervals[bucket];
+        }
+    }
+    m_lastDownMs = timeMs;
+    m_hasLastDown = true;
+
+    // 只统计不带 Ctrl/Alt/Win 的字符键
+    if (isTypingKey(vk) && (mods & ~VK_MOD_SHIFT) == 0) {
+        uint32_t sec = timeMs / 1000;
+        uint32_t slot = sec % WPM_WINDOW_SEC;
+        if (m_wpmSeconds[slot] != sec) {
+            m_wpmSeconds[slot] = sec;
+            m_wpmCounts[slot] = 0;
+        }
+        ++m_wpmCounts[slot];
+        g_liveWpm.store(wpm(timeMs), std::memory_order_relaxed);
+        g_liveWpmTime.store(timeMs, std::memory_order_relaxed);
+    }
+
+    if (!m_dirty) {
+        m_dirty = true;
+        m_dirtySinceMs = timeMs;
+    }
+}
+
+float KeyStats::wpm(uint32_t nowMs) const {
+    uint32_t nowSec = nowMs / 1000;
+    uint32_t chars = 0;
+    for (uint32_t i = 0; i < WPM_WINDOW_SEC; ++i) {
+        if (nowSec - m_wpmSeconds[i] < WPM_WINDOW_SEC) chars += m_wpmCounts[i];
+    }
+    return static_cast<float>(chars) / 5.f * (60.f / WPM_WINDOW_SEC);
+}
+
+bool KeyStats::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    uint32_t magic = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    if (!file || magic != KEY_STATS_MAGIC) return false;
+
+    KeyStats loaded;
+    file.read(reinterpret_cast<char*>(loaded.m_vkCounts.data()), sizeof(loaded.m_vkCounts));
+    file.read(reinterpret_cast<char*>(loaded.m_intervals.data()), sizeof(loaded.m_intervals));
+    uint32_t comboEntries = 0;
+    file.read(reinterpret_cast<char*>(&comboEntries), sizeof(comboEntries));
+    if (!file || comboEntries > loaded.m_comboCounts.size()) return false;
+    for (uint32_t i = 0; i < comboEntries; ++i) {
+        uint16_t index = 0;
+        uint32_t count = 0;
+        file.read(reinterpret_cast<char*>(&index), sizeof(index));
+        file.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!file || index >= loaded.m_comboCounts.size()) return false;
+        loaded.m_comboCounts[index] = count;
+    }
+
+    m_vkCounts = loaded.m_vkCounts;
+    m_comboCounts = loaded.m_comboCounts;
+    m_intervals = loaded.m_intervals;
+    return true;
+}
+
+bool KeyStats::save(const std::string& path) {
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+
+        file.write(reinterpret_cast<const char*>(&KEY_STATS_MAGIC), sizeof(KEY_STATS_MAGIC));
+        file.write(reinterpret_cast<const char*>(m_vkCounts.data()), sizeof(m_vkCounts));
+        file.write(reinterpret_cast<const char*>(m_intervals.data()), sizeof(m_intervals));
+
+        uint32_t comboEntries = 0;
+        for (uint32_t count : m_comboCounts) comboEntries += count != 0;
+        file.write(reinterpret_cast<const char*>(&comboEntries), sizeof(comboEntries));
+        for (uint32_t i = 0; i < m_comboCounts.size(); ++i) {
+            if (m_comboCounts[i] == 0) continue;
+            auto index = static_cast<uint16_t>(i);
+            file.write(reinterpret_cast<const char*>(&index), sizeof(index));
+            file.write(reinterpret_cast<const char*>(&m_comboCounts[i]), sizeof(m_comboCounts[i]));
+        }
+        if (!file.flush()) return false;
+    }
+
+    // 原子替换，写入中途退出不会留下损坏的统计文件
+    if (!MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        DeleteFileA(tempPath.c_str());
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
+
+void KeyStats::flushIfDue(const std::string& path, uint32_t nowMs) {
+    if (msUntilFlush(nowMs) != 0) return;
+    // 写入失败时等下一个间隔再重试
+    if (!save(path)) m_dirtySinceMs = nowMs;
+}
+
+uint32_t KeyStats::msUntilFlush(uint32_t nowMs) const {
+    if (!m_dirty) return UINT32_MAX;
+    uint32_t elapsed = nowMs - m_dirtySinceMs;
+    return elapsed >= FLUSH_INTERVAL_MS ? 0 : FLUSH_INTERVAL_MS - elapsed;
+}
+
+float getTypingWpm() {
+    // 停止打字后按窗口长度线性衰减到0
+    uint32_t idle = GetTickCount() - g_liveWpmTime.load(std::memory_order_relaxed);
+    constexpr uint32_t windowMs = KeyStats::WPM_WINDOW_SEC * 1000;
+    if (idle >= windowMs) return 0.f;
+    return g_liveWpm.load(std::memory_order_relaxed) * (1.f - static_cast<float>(idle) / windowMs);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "key_state.h"
+
+// 键盘统计：按键次数、组合键次数、按键间隔直方图、滑动窗口WPM
+// 只由字幕线程按事件顺序写入，全部为定长数组，可全天常驻
+class KeyStats {
+public:
+    static constexpr uint32_t MOD_COMBOS = 16;            // Ctrl/Alt/Shift/Win 四位组合（同 VK_MOD_COUNT）
+    static constexpr uint32_t INTERVAL_BUCKETS = 64;      // 间隔直方图桶数，最后一桶为溢出桶
+    static constexpr uint32_t INTERVAL_BUCKET_MS = 16;    // 每桶宽度
+    static constexpr uint32_t INTERVAL_PAUSE_MS = 2000;   // 超过该间隔视为停顿，不计入直方图
+    static constexpr uint32_t WPM_WINDOW_SEC = 10;        // WPM滑动窗口
+    static constexpr uint32_t FLUSH_INTERVAL_MS = 60000;  // 落盘间隔
+
+    // 记录一次新按下（pressed 为按下后的完整按键集合，timeMs 为钩子事件时间）
+    void onKeyDown(uint32_t vk, uint32_t timeMs, const KeyState& pressed);
+
+    // 滑动窗口内的打字速度（每5个字符计1词）
+    [[nodiscard]] float wpm(uint32_t nowMs) const;
+
+    // 读取/写入统计文件（写入先写临时文件再原子替换）
+    bool load(const std::string& path);
+    bool save(const std::string& path);
+
+    // 到达落盘间隔且有新数据时写入文件
+    void flushIfDue(const std::string& path, uint32_t nowMs);
+    // 距下次需要落盘的毫秒数（无新数据时为 UINT32_MAX）
+    [[nodiscard]] uint32_t msUntilFlush(uint32_t nowMs) const;
+
+    [[nodiscard]] uint32_t vkCount(uint32_t vk) const { return vk < 256 ? m_vkCounts[vk] : 0; }
+    [[nodiscard]] uint32_t comboCount(uint32_t mods, uint32_t vk) const {
+        return mods < MOD_COMBOS && vk < 256 ? m_comboCounts[mods * 256 + vk] : 0;
+    }
+    [[nodiscard]] const std::array<uint32_t, INTERVAL_BUCKETS>& intervals() const { return m_intervals; }
+
+private:
+    std::array<uint32_t, 256> m_vkCounts{};
+    std::array<uint32_t, MOD_COMBOS * 256> m_comboCounts{};
+    std::array<uint32_t, INTERVAL_BUCKETS> m_intervals{};
+
+    // WPM环形槽：每秒一个槽，记录该秒的字符数和所属秒
+    std::array<uint32_t, WPM_WINDOW_SEC> m_wpmCounts{};
+    std::array<uint32_t, WPM_WINDOW_SEC> m_wpmSeconds{};
+
+    uint32_t m_lastDownMs = 0;
+    bool m_hasLastDown = false;
+    bool m_dirty = false;
+    uint32_t m_dirtySinceMs = 0;
+};
+
+// 当前打字速度（任意线程可读，供桌宠根据打字节奏做反应）
+float getTypingWpm();
@@ -1,49 +1,64 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <deque>
 #include <map>
-#include <mutex>
 #include <set>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include <windows.h>
 
 #include "keyboard_hook_tool.h"
 #include "vk_code_2_string.h"
 
-extern std::mutex g_lockStateMutex;
 extern bool g_capsOn;
 extern bool g_numOn;
 extern bool g_scrollOn;
 
-// 全局符号映射表
-static std::map<char, char> g_symbolMap = { };
-
-// 符号映射表-EN
-static std::map<char, char> g_symbolMapEN = { };
+// 符号映射表-EN（值为UTF-8，中文符号不是单字节）
+static const std::map<char, std::string_view> g_symbolMapEN = { };
 
 // 符号映射表-CN
-static std::map<char, char> g_symbolMapCN = {
-    {'$', '￥'}, {'`', '·'},
+static const std::map<char, std::string_view> g_symbolMapCN = {
+    {'$', "￥"}, {'`', "·"},
 };
 
-// 判断当前输入法是否为中文输入模式
+// 当前符号映射表（按输入法模式指向静态表，不复制）
+static const std::map<char, std::string_view>* g_symbolMap = &g_symbolMapEN;
+
+// 当前是否使用中文符号映射（参与标签缓存的键）
+static bool g_symbolMapIsCN = false;
+
+// 输入法状态采样间隔与查询超时（毫秒）
+constexpr ULONGLONG IME_SAMPLE_INTERVAL_MS = 500;
+constexpr UINT IME_QUERY_TIMEOUT_MS = 50;
+
+// 判断当前输入法是否为中文输入模式（前台程序无响应时沿用上次结果，不阻塞字幕线程）
 bool IsChineseInput() {
     HWND hIME = ImmGetDefaultIMEWnd(GetForegroundWindow());
-    LRESULT status = SendMessage(hIME, WM_IME_CONTROL, 0x0005, 0);
+    if (!hIME) return false;
+    DWORD_PTR status = 0;
+    if (!SendMessageTimeout(hIME, WM_IME_CONTROL, 0x0005, 0,
+            SMTO_ABORTIFHUNG | SMTO_BLOCK, IME_QUERY_TIMEOUT_MS, &status)) {
+        return g_symbolMapIsCN;
+    }
     return status ? true : false;
 }
 
-// 根据输入法HKL自动切换符号映射表
-void setSymbolMap() {
-    if (IsChineseInput()) {
-        // 中文输入法
-        g_symbolMap = g_symbolMapCN;
-    } else {
-        // 英文或其它
-        g_symbolMap = g_symbolMapEN;
-    }
+// 根据输入法状态切换符号映射表（未到采样间隔时直接返回，force 立即采样）
+void setSymbolMap(bool force) {
+    static ULONGLONG lastSample = 0;
+    ULONGLONG now = GetTickCount64();
+    if (!force && lastSample != 0 && now - lastSample < IME_SAMPLE_INTERVAL_MS) return;
+    lastSample = now;
+
+    g_symbolMapIsCN = IsChineseInput();
+    // 中文输入法 / 英文或其它
+    g_symbolMap = g_symbolMapIsCN ? &g_symbolMapCN : &g_symbolMapEN;
 }
 
 // 圆角矩形辅助函数
@@ -99,7 +114,7 @@ private:
 
 // 工具函数：历史栏符号处理（适用于interVkTables和mainNumVkTables）
 sf::String symbolForHistory(
-    const std::string& n,
+    std::string_view n,
     const std::set<std::string>& modKeys,
     bool forHistory,
     bool isMiscChar
@@ -121,10 +136,10 @@ sf::String symbolForHistory(
         }
         if (ch) {
             // 查映射表，若有则替换
-            auto it = g_symbolMap.find(ch);
-            if (it != g_symbolMap.end()) {
+            auto it = g_symbolMap->find(ch);
+            if (it != g_symbolMap->end()) {
                 // 输出映射后的符号
-                return sf::String::fromUtf8(&it->second, &it->second + 1);
+                return sf::String::fromUtf8(it->second.begin(), it->second.end());
             }
             // 没有映射则原样输出
             return sf::String::fromUtf8(&ch, &ch + 1);
@@ -134,92 +149,79 @@ sf::String symbolForHistory(
     return sf::String::fromUtf8(n.begin(), n.end());
 }
 
-// 修改comboToString，增加forHistory参数
-sf::String comboToString(const std::set<DWORD>& keys, bool forHistory) {
-    static const std::vector<std::string> priority = {"Win", "Ctrl", "Alt", "Shift"};
-    std::vector<std::string> ordered;
-    std::vector<std::string> others;
-
-    bool capsOn, numOn, scrollOn;
-    {
-        std::lock_guard lock(g_lockStateMutex);
-        capsOn = g_capsOn;
-        numOn = g_numOn;
-        scrollOn = g_scrollOn;
+// 修饰键优先级
+static constexpr std::string_view kModPriority[] = {"Win", "Ctrl", "Alt", "Shift"};
+
+// 修饰键的归一化名称（去掉L/R前缀），非修饰键返回空
+static std::string_view modifierBase(std::string_view name) {
+    for (auto pri : kModPriority) {
+        if (name == pri) return pri;
+        if (name.size() > 1 && (name[0] == 'L' || name[0] == 'R') && name.substr(1) == pri) return pri;
     }
+    return {};
+}
 
-    if (keys.size() == 1) {
-        DWORD vk = *keys.begin();
+// 修改comboToString，增加forHistory参数
+sf::String comboToString(const KeyState& keys, bool forHistory) {
+    // 非修饰键：名称 + 在主表中生效的分类
+    struct OtherKey {
+        std::string_view name;
+        uint32_t category;
+    };
+    std::vector<std::string_view> ordered;
+    std::vector<OtherKey> others;
+
+    bool capsOn = g_capsOn;
+    bool numOn = g_numOn;
+    bool scrollOn = g_scrollOn;
+
+    if (keys.count() == 1) {
+        DWORD vk = keys.first();
         if (vk == VK_CAPITAL) return capsOn ? L"CapsOn" : L"CapsOff";
         if (vk == VK_NUMLOCK) return numOn ? L"NumLockOn" : L"NumLockOff";
         if (vk == VK_SCROLL) return scrollOn ? L"ScrollLockOn" : L"ScrollLockOff";
     }
 
+    const VkTable& mainTable = getMainVkTable();
     std::set<std::string> modKeys;
-    for (const auto& pri : priority) {
-        for (DWORD vk : keys) {
-            std::string name = vkCodeToString(static_cast<int>(vk));
-            if (name.size() > 1 && (name[0] == 'L' || name[0] == 'R')) {
-                std::string base = name.substr(1);
-                if (base == pri) {
-                    modKeys.insert(pri);
-                    ordered.push_back(pri);
-                    continue;
-                }
-            }
-            if (name == pri) {
-                modKeys.insert(pri);
+    for (auto pri : kModPriority) {
+        keys.forEach([&](uint32_t vk) {
+            if (modifierBase(vkCodeToString(static_cast<int>(vk))) == pri) {
+                modKeys.emplace(pri);
                 ordered.push_back(pri);
             }
-        }
+        });
     }
 
-    for (DWORD vk : keys) {
-        std::string name = vkCodeToString(static_cast<int>(vk));
-        bool isMod = false;
-        for (const auto& pri : priority) {
-            if (name == pri) { isMod = true; break; }
-            if (name.size() > 1 && (name[0] == 'L' || name[0] == 'R') && name.substr(1) == pri) {
-                isMod = true; break;
-            }
+    keys.forEach([&](uint32_t vk) {
+        std::string_view name = vkCodeToString(static_cast<int>(vk));
+        if (modifierBase(name).empty()) {
+            others.push_back({name, vkCategory(static_cast<int>(vk)) & mainTable.mask});
         }
-        if (!isMod) others.push_back(name);
-    }
+    });
 
     bool onlyAlpha = false;
     bool onlyShiftAlpha = false;
-    if (others.size() == 1 && others[0].size() == 1 && std::isalpha(others[0][0])) {
-        onlyAlpha = (keys.size() == 1);
-        onlyShiftAlpha = (keys.size() == 2 && modKeys.count("Shift") == 1);
+    if (others.size() == 1 && others[0].name.size() == 1 && std::isalpha(others[0].name[0])) {
+        onlyAlpha = (keys.count() == 1);
+        onlyShiftAlpha = (keys.count() == 2 && modKeys.count("Shift") == 1);
     }
 
-    // interVkTables符号处理
-    const VkTable& interTable = interVkTables();
-    const VkTable& mainNumTable = mainNumVkTables();
-
     sf::String s;
     bool first = true;
-    for (const auto& n : ordered) {
+    for (auto n : ordered) {
         // interVkTables/mainNumVkTables符号处理：历史栏且只和shift组合时，不输出shift+，只输出符号
         if (g_enableSpecialAlpha && forHistory && modKeys.size() == 1 && modKeys.count("Shift") == 1) {
-            if (others.size() == 1 && n == "Shift") {
-                // interVkTables
-                if (interTable.end() != std::find_if(interTable.begin(), interTable.end(),
-                    [&](const std::pair<int, std::string>& p) { return p.second == others[0]; }) && others[0].size() == 2) {
-                    continue; // 跳过shift
-                }
-                // mainNumVkTables
-                if (mainNumTable.end() != std::find_if(mainNumTable.begin(), mainNumTable.end(),
-                    [&](const std::pair<int, std::string>& p) { return p.second == others[0]; }) && others[0].size() == 2) {
-                    continue; // 跳过shift
-                }
+            if (others.size() == 1 && n == "Shift" && others[0].name.size() == 2 &&
+                (others[0].category & (VK_CAT_INTER | VK_CAT_MAIN_NUM))) {
+                continue; // 跳过shift
             }
         }
         if (!first) s += L" + ";
         s += sf::String::fromUtf8(n.begin(), n.end());
         first = false;
     }
-    for (const auto& n : others) {
+    for (const auto& [n, category] : others) {
         if (!first) s += L" + ";
         // 字母键大小写处理
         if (n.size() == 1 && std::isalpha(n[0])) {
@@ -235,15 +237,13 @@ sf::String comboToString(const std::set<DWORD>& keys, bool forHistory) {
             s += sf::String::fromUtf8(&ch, &ch + 1);
         }
         // interVkTables符号处理
-        else if (interTable.end() != std::find_if(interTable.begin(), interTable.end(),
-            [&](const std::pair<int, std::string>& p) { return p.second == n; })) {
+        else if (category & VK_CAT_INTER) {
             bool isMiscChar = (n == "MiscChar");
             // 总是输出双符号，只有历史栏且只和shift/无修饰时输出单符号
             s += symbolForHistory(n, modKeys, forHistory, isMiscChar);
         }
         // mainNumVkTables符号处理
-        else if (mainNumTable.end() != std::find_if(mainNumTable.begin(), mainNumTable.end(),
-            [&](const std::pair<int, std::string>& p) { return p.second == n; })) {
+        else if (category & VK_CAT_MAIN_NUM) {
             // 总是输出双符号，只有历史栏且只和shift/无修饰时输出单符号
             s += symbolForHistory(n, modKeys, forHistory, false);
         }
@@ -264,95 +264,109 @@ sf::String comboToString(const std::set<DWORD>& keys, bool forHistory) {
 
 // 从组合中提取modKeys和others
 void extractModKeysAndOthers(
-    const std::set<DWORD>& combo,
+    const KeyState& combo,
     std::set<std::string>& modKeys,
     std::vector<std::string>& others
 ) {
-    static const std::vector<std::string> priority = {"Win", "Ctrl", "Alt", "Shift"};
-    for (const auto& pri : priority) {
-        for (DWORD vk2 : combo) {
-            std::string name = vkCodeToString(static_cast<int>(vk2));
-            if (name.size() > 1 && (name[0] == 'L' || name[0] == 'R')) {
-                std::string base = name.substr(1);
-                if (base == pri) {
-                    modKeys.insert(pri);
-                    continue;
-                }
+    for (auto pri : kModPriority) {
+        combo.forEach([&](uint32_t vk2) {
+            if (modifierBase(vkCodeToString(static_cast<int>(vk2))) == pri) {
+                modKeys.emplace(pri);
             }
-            if (name == pri) {
-                modKeys.insert(pri);
-            }
-        }
+        });
     }
-    for (DWORD vk2 : combo) {
-        std::string name = vkCodeToString(static_cast<int>(vk2));
-        bool isMod = false;
-        for (const auto& pri : priority) {
-            if (name == pri) { isMod = true; break; }
-            if (name.size() > 1 && (name[0] == 'L' || name[0] == 'R') && name.substr(1) == pri) {
-                isMod = true; break;
-            }
+    combo.forEach([&](uint32_t vk2) {
+        std::string_view name = vkCodeToString(static_cast<int>(vk2));
+        if (modifierBase(name).empty()) others.emplace_back(name);
+    });
+}
+
+// 组合键标签缓存键：按键集合 + 影响标签的状态位
+struct ComboLabelKey {
+    KeyState keys;
+    uint32_t flags = 0;
+    bool operator==(const ComboLabelKey&) const = default;
+};
+
+struct ComboLabelKeyHash {
+    size_t operator()(const ComboLabelKey& k) const {
+        uint64_t h = k.flags;
+        for (uint64_t w : k.keys.words) {
+            h ^= w + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
         }
-        if (!isMod) others.push_back(name);
+        return static_cast<size_t>(h);
     }
+};
+
+// 超过上限时整体清空（正常使用中组合数远小于上限）
+constexpr size_t COMBO_LABEL_CACHE_LIMIT = 512;
+
+// 组合键UTF-8标签（带缓存，仅在按键集合或状态变化时重新生成）
+const std::string& comboLabel(const KeyState& keys, bool forHistory) {
+    static std::unordered_map<ComboLabelKey, std::string, ComboLabelKeyHash> cache;
+
+    uint32_t flags = 0;
+    if (forHistory) flags |= 1u << 0;
+    if (g_capsOn) flags |= 1u << 1;
+    if (g_numOn) flags |= 1u << 2;
+    if (g_scrollOn) flags |= 1u << 3;
+    if (g_symbolMapIsCN) flags |= 1u << 4;
+    if (g_enableSpecialAlpha) flags |= 1u << 5;
+
+    ComboLabelKey key{keys, flags};
+    if (auto it = cache.find(key); it != cache.end()) return it->second;
+
+    if (cache.size() >= COMBO_LABEL_CACHE_LIMIT) cache.clear();
+    auto utf8 = comboToString(keys, forHistory).toUtf8();
+    return cache.emplace(key, std::string(utf8.begin(), utf8.end())).first->second;
 }
 
 // 处理新按下的键并弹出历史字幕
 void handleNewlyPressed(
-    const std::set<DWORD>& newlyPressed,
-    const std::set<DWORD>& pressedCopy,
+    const KeyState& newlyPressed,
+    const KeyState& pressedCopy,
     std::deque<SubtitleEntry>& subtitles,
     const size_t MAX_SUBTITLES,
     float SUBTITLE_DURATION
 ) {
-    static const std::vector<std::string> priority = {"Win", "Ctrl", "Alt", "Shift"};
-    const VkTable& modifyTable = modifyVkTables();
-
-    auto isModifyKey = [&](DWORD vk) {
-        return modifyTable.find(static_cast<int>(vk)) != modifyTable.end();
-    };
-
-    bool hasModify = false;
-    std::set<DWORD> currentModifyKeys;
-    for (DWORD vk : pressedCopy) {
-        if (isModifyKey(vk)) {
-            hasModify = true;
-            currentModifyKeys.insert(vk);
+    // 修饰键掩码（由修饰键分表生成一次）
+    static const KeyState modifyMask = [] {
+        KeyState mask;
+        for (uint32_t vk = 0; vk < 256; ++vk) {
+            if (modifyVkTables().contains(static_cast<int>(vk))) mask.set(vk);
         }
-    }
+        return mask;
+    }();
 
-    for (DWORD vk : newlyPressed) {
-        std::set single{vk};
-        if ((vk == VK_CAPITAL || vk == VK_NUMLOCK || vk == VK_SCROLL) && pressedCopy.size() == 1) {
-            std::string histText = comboToString(single, true).toAnsiString();
+    bool hasModify = !(pressedCopy & modifyMask).empty();
+
+    newlyPressed.forEach([&](uint32_t vk) {
+        KeyState single = KeyState::single(vk);
+        if ((vk == VK_CAPITAL || vk == VK_NUMLOCK || vk == VK_SCROLL) && pressedCopy.count() == 1) {
+            const std::string& histText = comboLabel(single, true);
             subtitles.push_back({histText, SUBTITLE_DURATION});
             if (subtitles.size() > MAX_SUBTITLES)
                 subtitles.pop_front();
         }
         else if (!hasModify) {
-            std::string histText = comboToString(single, true).toAnsiString();
+            const std::string& histText = comboLabel(single, true);
             subtitles.push_back({histText, SUBTITLE_DURATION});
             if (subtitles.size() > MAX_SUBTITLES)
                 subtitles.pop_front();
         } else {
-            const std::set<DWORD>& combo = pressedCopy;
+            const KeyState& combo = pressedCopy;
             std::set<std::string> modKeys;
             std::vector<std::string> others;
             extractModKeysAndOthers(combo, modKeys, others);
 
             bool onlyShiftAlpha = false;
             if (others.size() == 1 && others[0].size() == 1 && std::isalpha(others[0][0])) {
-                onlyShiftAlpha = (combo.size() == 2 && modKeys.count("Shift") == 1);
+                onlyShiftAlpha = (combo.count() == 2 && modKeys.count("Shift") == 1);
             }
 
             if (onlyShiftAlpha) {
                 char ch = others[0][0];
-                bool capsOn;
-                {
-                    std::lock_guard lock(g_lockStateMutex);
-                    capsOn = g_capsOn;
-                }
-                if (capsOn)
+                if (g_capsOn)
                     ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
                 else
                     ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
@@ -361,19 +375,82 @@ void handleNewlyPressed(
                 if (subtitles.size() > MAX_SUBTITLES)
                     subtitles.pop_front();
             } else {
-                std::string histText = comboToString(combo, true).toAnsiString();
+                const std::string& histText = comboLabel(combo, true);
                 subtitles.push_back({histText, SUBTITLE_DURATION});
                 if (subtitles.size() > MAX_SUBTITLES)
                     subtitles.pop_front();
             }
         }
+    });
+}
+
+// 透明度量化步长：淡出时只有跨过一个量化级才需要重绘
+constexpr int ALPHA_QUANTUM = 8;
+
+static int quantizeAlpha(float alpha) {
+    int q = static_cast<int>(std::lround(alpha / ALPHA_QUANTUM)) * ALPHA_QUANTUM;
+    return std::clamp(q, 0, 255);
+}
+
+// 历史栏背景透明度
+static int subtitleBubbleAlpha(float timer, float SUBTITLE_DURATION) {
+    return quantizeAlpha(180.f * std::clamp(timer / SUBTITLE_DURATION, 0.f, 1.f));
+}
+
+// 历史栏文字透明度（对数曲线，先慢后快）
+static int subtitleTextAlpha(float timer, float SUBTITLE_DURATION) {
+    float ratio = std::max(0.f, timer / SUBTITLE_DURATION);
+    return quantizeAlpha(255.f * std::log1p(5 * ratio) / std::log1p(5.f));
+}
+
+// 圆角矩形轮廓转为三角形（凸多边形，以中心为扇心），追加到批量顶点中
+static void appendRoundedRect(
+    sf::VertexArray& out,
+    const std::vector<sf::Vector2f>& outline,
+    sf::Vector2f offset,
+    sf::Vector2f size,
+    sf::Color color
+) {
+    sf::Vector2f center = offset + size / 2.f;
+    for (std::size_t i = 0; i < outline.size(); ++i) {
+        const sf::Vector2f& p0 = outline[i];
+        const sf::Vector2f& p1 = outline[(i + 1) % outline.size()];
+        out.append(sf::Vertex(center, color));
+        out.append(sf::Vertex(offset + p0, color));
+        out.append(sf::Vertex(offset + p1, color));
     }
 }
 
+// 生成圆角矩形轮廓点（局部坐标）
+static std::vector<sf::Vector2f> roundedRectOutline(sf::Vector2f size) {
+    RoundedRectangleShape shape(size, 8.f, 16);
+    std::vector<sf::Vector2f> outline(shape.getPointCount());
+    for (std::size_t i = 0; i < outline.size(); ++i) outline[i] = shape.getPoint(i);
+    return outline;
+}
+
+// 构建字幕条目的文字几何（每个条目只构建一次）
+static void buildSubtitleEntry(SubtitleEntry& entry, const sf::Font& fontZh, const sf::Font& fontEn) {
+    entry.prefix.setFont(fontZh);
+    entry.prefix.setCharacterSize(20);
+    entry.prefix.setString(L"历史： ");
+    entry.prefix.setOutlineThickness(3);
+
+    entry.label.setFont(fontEn);
+    entry.label.setCharacterSize(20);
+    entry.label.setString(sf::String::fromUtf8(entry.text.begin(), entry.text.end()));
+    entry.label.setOutlineThickness(3);
+
+    entry.alpha = -1;
+    entry.bgAlpha = -1;
+    entry.built = true;
+}
+
 // 绘制历史字幕
 void drawHistorySubtitles(
     sf::RenderTarget& window,
-    const std::deque<SubtitleEntry>& subtitles,
+    SubtitleGeometry& geometry,
+    std::deque<SubtitleEntry>& subtitles,
     const sf::Font& fontZh,
     const sf::Font& fontEn,
     float baseY,
@@ -382,76 +459,78 @@ void drawHistorySubtitles(
     float subtitleWidth,
     float subtitleLeft
 ) {
-    int idx = 0;
-    // 让上面的字幕更透明且先消失
-    for (auto it = subtitles.rbegin(); it != subtitles.rend(); ++it, ++idx) {
-        float alpha = std::clamp(it->timer / SUBTITLE_DURATION, 0.f, 1.f);
-
-        // 计算实际文本高度
-        sf::Text textZh;
-        textZh.setFont(fontZh);
-        textZh.setCharacterSize(20);
-        textZh.setString(L"历史： ");
+    // 背景尺寸只取决于字体和窗口宽度
+    if (geometry.historyOutline.empty() || geometry.historyWidth != subtitleWidth) {
+        sf::Text measure;
+        measure.setFont(fontZh);
+        measure.setCharacterSize(20);
+        measure.setString(L"历史： ");
+        float textHeight = measure.getLocalBounds().height + 6;
+        geometry.historyHeight = textHeight + 9.f; // 适当加padding
+        geometry.historyWidth = subtitleWidth;
+        geometry.historyOutline = roundedRectOutline({subtitleWidth, geometry.historyHeight});
+        geometry.historyLayoutSize = 0;
+    }
 
-        sf::Text textEn;
-        textEn.setFont(fontEn);
-        textEn.setCharacterSize(20);
-        textEn.setString(sf::String::fromUtf8(it->text.begin(), it->text.end()));
+    float bgHeight = geometry.historyHeight;
+    sf::Vector2f bgSize(subtitleWidth, bgHeight);
 
-        float textHeight = textZh.getLocalBounds().height + 6;
-        float bgHeight = textHeight + 9.f; // 适当加padding
-        float yPos = baseY - idx * (bgHeight + subtitleMargin);
+    // 条目增减时才重排位置，其余帧只改透明度
+    const SubtitleEntry* back = subtitles.empty() ? nullptr : &subtitles.back();
+    bool relayout = geometry.historyLayoutSize != subtitles.size() || geometry.historyLayoutBack != back;
+    geometry.historyLayoutSize = subtitles.size();
+    geometry.historyLayoutBack = back;
 
-        // 使用圆角矩形
-        RoundedRectangleShape bg({subtitleWidth, bgHeight}, 8.f, 16);
-        bg.setPosition(0.f, yPos);
-        bg.setFillColor(sf::Color(0, 0, 0, static_cast<sf::Uint8>(180 * alpha)));
-        window.draw(bg);
-    }
+    std::size_t vertsPerBubble = geometry.historyOutline.size() * 3;
+    if (relayout) geometry.historyBubbles.clear();
 
-    idx = 0;
+    int idx = 0;
+    // 让上面的字幕更透明且先消失
     for (auto it = subtitles.rbegin(); it != subtitles.rend(); ++it, ++idx) {
-        sf::Text textZh;
-        textZh.setFont(fontZh);
-        textZh.setCharacterSize(20);
-        textZh.setString(L"历史： ");
-
-        sf::Text textEn;
-        textEn.setFont(fontEn);
-        textEn.setCharacterSize(20);
-        textEn.setString(sf::String::fromUtf8(it->text.begin(), it->text.end()));
-        float textHeight = textZh.getLocalBounds().height + 6;
-        float bgHeight = textHeight + 9.f;
+        int bgAlpha = subtitleBubbleAlpha(it->timer, SUBTITLE_DURATION);
+        sf::Color bgColor(0, 0, 0, static_cast<sf::Uint8>(bgAlpha));
         float yPos = baseY - idx * (bgHeight + subtitleMargin);
 
-        float ratio = std::max(0.f, it->timer / SUBTITLE_DURATION);
-        float alpha = 255.f * std::log1p(5 * ratio) / std::log1p(5.f);
-        auto a = static_cast<sf::Uint8>(alpha);
-
-        textZh.setFillColor(sf::Color(255, 255, 255, a));
-        textZh.setOutlineColor(sf::Color(0, 0, 0, a));
-        textZh.setOutlineThickness(3);
-        textZh.setPosition(subtitleLeft, yPos + 4);
-
-        window.draw(textZh);
+        if (!it->built) buildSubtitleEntry(*it, fontZh, fontEn);
+
+        if (relayout) {
+            appendRoundedRect(geometry.historyBubbles, geometry.historyOutline, {0.f, yPos}, bgSize, bgColor);
+            it->bgAlpha = bgAlpha;
+            it->prefix.setPosition(subtitleLeft, yPos + 4);
+            float offsetX2 = subtitleLeft + (it->prefix.getLocalBounds().width + it->prefix.getLocalBounds().left);
+            it->label.setPosition(offsetX2, yPos + 9);
+        } else if (it->bgAlpha != bgAlpha) {
+            it->bgAlpha = bgAlpha;
+            std::size_t begin = idx * vertsPerBubble;
+            for (std::size_t v = begin; v < begin + vertsPerBubble; ++v) geometry.historyBubbles[v].color = bgColor;
+        }
 
-        if (!it->text.empty()) {
-            textEn.setFillColor(sf::Color(255, 255, 255, a));
-            textEn.setOutlineColor(sf::Color(0, 0, 0, a));
-            textEn.setOutlineThickness(3);
-            float offsetX2 = textZh.getPosition().x + (textZh.getLocalBounds().width + textZh.getLocalBounds().left);
-            textEn.setPosition(offsetX2, yPos + 9);
-            window.draw(textEn);
+        int a = subtitleTextAlpha(it->timer, SUBTITLE_DURATION);
+        if (it->alpha != a) {
+            it->alpha = a;
+            auto a8 = static_cast<sf::Uint8>(a);
+            it->prefix.setFillColor(sf::Color(255, 255, 255, a8));
+            it->prefix.setOutlineColor(sf::Color(0, 0, 0, a8));
+            it->label.setFillColor(sf::Color(255, 255, 255, a8));
+            it->label.setOutlineColor(sf::Color(0, 0, 0, a8));
         }
     }
+
+    // 背景一次批量绘制，文字几何直接复用
+    window.draw(geometry.historyBubbles);
+    for (auto it = subtitles.rbegin(); it != subtitles.rend(); ++it) {
+        window.draw(it->prefix);
+        if (!it->text.empty()) window.draw(it->label);
+    }
 }
 
 // 绘制当前栏
 void drawCurrentBar(
     sf::RenderTarget& window,
+    SubtitleGeometry& geometry,
     const sf::Font& fontZh,
     const sf::Font& fontEn,
-    const std::set<DWORD>& pressedCopy,
+    const KeyState& pressedCopy,
     float subtitleWidth,
     float subtitleHeight,
     float subtitleLeft
@@ -460,72 +539,93 @@ void drawCurrentBar(
     float currentBarHeight = subtitleHeight * 1.2f;
     float currentBarY = static_cast<float>(window.getSize().y) - currentBarHeight;
 
-    // 使用圆角矩形
-    RoundedRectangleShape currentBarBg({subtitleWidth, currentBarHeight}, 8.f, 16);
-    currentBarBg.setPosition(0.f, currentBarY);
-    currentBarBg.setFillColor(sf::Color(0, 0, 0, 191));
-    window.draw(currentBarBg);
-
-    sf::Text currentZh;
-    currentZh.setFont(fontZh);
-    currentZh.setCharacterSize(24);
-    currentZh.setFillColor(sf::Color::White);
-
-    // 垂直居中
-    float zhOffsetY = currentBarY + (currentBarHeight - currentZh.getLocalBounds().height) / 2.f - 15.f;
-    currentZh.setPosition(subtitleLeft, zhOffsetY);
-    currentZh.setString(L"当前： ");
-    currentZh.setOutlineColor(sf::Color(0, 0, 0, 191));
-    currentZh.setOutlineThickness(3);
-
-    sf::Text currentEn;
-    currentEn.setFont(fontEn);
-    currentEn.setCharacterSize(24);
-    currentEn.setFillColor(sf::Color::White);
-
-    float offsetX = currentZh.getPosition().x + currentZh.getLocalBounds().width;
-    currentEn.setPosition(offsetX, zhOffsetY + 5.f);
-    currentEn.setString(pressedCopy.empty() ? "" : comboToString(pressedCopy, false));
-    currentEn.setOutlineColor(sf::Color(0, 0, 0, 191));
-    currentEn.setOutlineThickness(3);
-
-    window.draw(currentZh);
-    window.draw(currentEn);
+    // 背景和前缀只在窗口尺寸变化时重建
+    if (!geometry.currentBuilt || geometry.currentBarWidth != subtitleWidth || geometry.currentBarY != currentBarY) {
+        geometry.currentBarWidth = subtitleWidth;
+        geometry.currentBarY = currentBarY;
+
+        // 使用圆角矩形
+        geometry.currentBubble.clear();
+        geometry.currentBubble.setPrimitiveType(sf::Triangles);
+        appendRoundedRect(geometry.currentBubble, roundedRectOutline({subtitleWidth, currentBarHeight}),
+            {0.f, currentBarY}, {subtitleWidth, currentBarHeight}, sf::Color(0, 0, 0, 191));
+
+        sf::Text& currentZh = geometry.currentPrefix;
+        currentZh.setFont(fontZh);
+        currentZh.setCharacterSize(24);
+        currentZh.setFillColor(sf::Color::White);
+
+        // 垂直居中
+        float zhOffsetY = currentBarY + currentBarHeight / 2.f - 15.f;
+        currentZh.setPosition(subtitleLeft, zhOffsetY);
+        currentZh.setString(L"当前： ");
+        currentZh.setOutlineColor(sf::Color(0, 0, 0, 191));
+        currentZh.setOutlineThickness(3);
+
+        sf::Text& currentEn = geometry.currentLabel;
+        currentEn.setFont(fontEn);
+        currentEn.setCharacterSize(24);
+        currentEn.setFillColor(sf::Color::White);
+
+        float offsetX = currentZh.getPosition().x + currentZh.getLocalBounds().width;
+        currentEn.setPosition(offsetX, zhOffsetY + 5.f);
+        currentEn.setString("");
+        currentEn.setOutlineColor(sf::Color(0, 0, 0, 191));
+        currentEn.setOutlineThickness(3);
+
+        geometry.currentText.clear();
+        geometry.currentBuilt = true;
+    }
+
+    // 标签变化时才重新排版文字
+    static const std::string empty;
+    const std::string& label = pressedCopy.empty() ? empty : comboLabel(pressedCopy, false);
+    if (label != geometry.currentText) {
+        geometry.currentText = label;
+        geometry.currentLabel.setString(sf::String::fromUtf8(label.begin(), label.end()));
+    }
+
+    window.draw(geometry.currentBubble);
+    window.draw(geometry.currentPrefix);
+    window.draw(geometry.currentLabel);
 }
 
-// 更新时间并移除过期字幕
-void updateAndCleanSubtitles(std::deque<SubtitleEntry>& subtitles, sf::Clock& clock) {
+// 更新时间并移除过期字幕，返回历史栏是否需要重绘（有条目过期或透明度跨过量化级）
+bool updateAndCleanSubtitles(std::deque<SubtitleEntry>& subtitles, sf::Clock& clock, float SUBTITLE_DURATION) {
     float dt = clock.restart().asSeconds();
+    bool changed = false;
     for (auto& entry : subtitles) {
         entry.timer -= dt;
+        if (entry.built &&
+            (entry.alpha != subtitleTextAlpha(entry.timer, SUBTITLE_DURATION) ||
+             entry.bgAlpha != subtitleBubbleAlpha(entry.timer, SUBTITLE_DURATION))) {
+            changed = true;
+        }
     }
-    while (!subtitles.empty() && subtitles.front().timer <= 0)
+    while (!subtitles.empty() && subtitles.front().timer <= 0) {
         subtitles.pop_front();
+        changed = true;
+    }
+    return changed;
 }
 
 // 记录每个键的绝对按下时间
 void updateKeyDownAbsTime(
-    const std::set<DWORD>& pressedCopy,
-    std::map<DWORD, sf::Time>& keyDownAbsTime,
+    const KeyState& pressedCopy,
+    KeyDownTimes& keyDownAbsTime,
     sf::Clock& globalClock
 ) {
-    for (DWORD vk : pressedCopy) {
-        if (keyDownAbsTime.find(vk) == keyDownAbsTime.end()) {
-            keyDownAbsTime[vk] = globalClock.getElapsedTime();
-        }
-    }
+    KeyState fresh = pressedCopy & ~keyDownAbsTime.tracked;
+    if (fresh.empty()) return;
+    sf::Time now = globalClock.getElapsedTime();
+    fresh.forEach([&](uint32_t vk) { keyDownAbsTime.time[vk] = now; });
+    keyDownAbsTime.tracked |= fresh;
 }
 
 // 清理已松开的键
 void cleanReleasedKeys(
-    const std::set<DWORD>& pressedCopy,
-    std::map<DWORD, sf::Time>& keyDownAbsTime
+    const KeyState& pressedCopy,
+    KeyDownTimes& keyDownAbsTime
 ) {
-    for (auto it = keyDownAbsTime.begin(); it != keyDownAbsTime.end(); ) {
-        if (pressedCopy.find(it->first) == pressedCopy.end()) {
-            it = keyDownAbsTime.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    keyDownAbsTime.tracked &= pressedCopy;
 }
@@ -1,39 +1,77 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <array>
 #include <deque>
-#include <map>
 #include <set>
 #include <string>
+#include <string_view>
+#include <vector>
 
-// 字幕结构体
+#include "key_state.h"
+
+// 字幕结构体（文字几何在首次绘制时构建并保留，之后每帧只更新位置和透明度）
 struct SubtitleEntry {
     std::string text;
     float timer;
+    bool built = false;
+    int alpha = -1;   // 已应用的文字透明度（量化后）
+    int bgAlpha = -1; // 已应用的背景透明度（量化后）
+    sf::Text prefix;
+    sf::Text label;
+};
+
+// 字幕窗口的保留几何（随字体在每次显示窗口时重建）
+struct SubtitleGeometry {
+    // 历史栏：所有背景合并为一个三角形数组
+    sf::VertexArray historyBubbles{sf::Triangles};
+    std::vector<sf::Vector2f> historyOutline;
+    float historyWidth = 0.f;
+    float historyHeight = 0.f;
+    std::size_t historyLayoutSize = 0;
+    const SubtitleEntry* historyLayoutBack = nullptr;
+
+    // 当前栏
+    bool currentBuilt = false;
+    float currentBarWidth = 0.f;
+    float currentBarY = 0.f;
+    sf::VertexArray currentBubble{sf::Triangles};
+    sf::Text currentPrefix;
+    sf::Text currentLabel;
+    std::string currentText;
 };
 
-// 支持直接用HKL切换符号映射表
-void setSymbolMap();
+// 每个键的绝对按下时间（按VK码平铺）
+struct KeyDownTimes {
+    KeyState tracked;
+    std::array<sf::Time, 256> time{};
+};
+
+// 按输入法状态切换符号映射表（按采样间隔节流，force 立即采样）
+void setSymbolMap(bool force = false);
 
 // 工具函数声明
 sf::String symbolForHistory(
-    const std::string& n,
+    std::string_view n,
     const std::set<std::string>& modKeys,
     bool forHistory,
     bool isMiscChar = false
 );
 
-sf::String comboToString(const std::set<DWORD>& keys, bool forHistory = false);
+sf::String comboToString(const KeyState& keys, bool forHistory = false);
+
+// 组合键的UTF-8标签（按按键集合、锁定键、输入法模式和特殊处理开关缓存）
+const std::string& comboLabel(const KeyState& keys, bool forHistory = false);
 
 void extractModKeysAndOthers(
-    const std::set<DWORD>& combo,
+    const KeyState& combo,
     std::set<std::string>& modKeys,
     std::vector<std::string>& others
 );
 
 void handleNewlyPressed(
-    const std::set<DWORD>& newlyPressed,
-    const std::set<DWORD>& pressedCopy,
+    const KeyState& newlyPressed,
+    const KeyState& pressedCopy,
     std::deque<SubtitleEntry>& subtitles,
     size_t MAX_SUBTITLES,
     float SUBTITLE_DURATION
@@ -41,7 +79,8 @@ void handleNewlyPressed(
 
 void drawHistorySubtitles(
     sf::RenderTarget& window,
-    const std::deque<SubtitleEntry>& subtitles,
+    SubtitleGeometry& geometry,
+    std::deque<SubtitleEntry>& subtitles,
     const sf::Font& fontZh,
     const sf::Font& fontEn,
     float baseY,
@@ -53,25 +92,26 @@ void drawHistorySubtitles(
 
 void drawCurrentBar(
     sf::RenderTarget& window,
+    SubtitleGeometry& geometry,
     const sf::Font& fontZh,
     const sf::Font& fontEn,
-    const std::set<DWORD>& pressedCopy,
+    const KeyState& pressedCopy,
     float subtitleWidth,
     float subtitleHeight,
     float subtitleLeft
 );
 
-void updateAndCleanSubtitles(std::deque<SubtitleEntry>& subtitles, sf::Clock& clock);
+bool updateAndCleanSubtitles(std::deque<SubtitleEntry>& subtitles, sf::Clock& clock, float SUBTITLE_DURATION);
 
 void updateKeyDownAbsTime(
-    const std::set<DWORD>& pressedCopy,
-    std::map<DWORD, sf::Time>& keyDownAbsTime,
+    const KeyState& pressedCopy,
+    KeyDownTimes& keyDownAbsTime,
     sf::Clock& globalClock
 );
 
 void cleanReleasedKeys(
-    const std::set<DWORD>& pressedCopy,
-    std::map<DWORD, sf::Time>& keyDownAbsTime
+    const KeyState& pressedCopy,
+    KeyDownTimes& keyDownAbsTime
 );
 
 // 判断当前输入法是否为中文输入模式
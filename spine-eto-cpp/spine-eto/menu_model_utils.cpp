@@ -1,21 +1,19 @@
 #include <chrono>
 #include <cstdio>
 #include <functional>
+#include <mutex>
 #include <windows.h>
 #include <vector>
 #include <string>
 
 #include "console_colors.h"
 #include "menu_model_utils.h"
+#include "model_database.h"
 #include "spine_animation.h"
 #include "spine_win_utils.h"
 #include "subtitle_window.h"
 #include "window_physics.h"
 
-#include "json.hpp"
-
-extern nlohmann::json g_modelDatabase;
-
 // 全局辉光信号变量
 bool g_showGlowEffect = false;
 // 全局交互半透明信号变量
@@ -25,58 +23,66 @@ bool g_showHalfAlpha = false;
 std::vector<MenuItemData> g_skinList;
 std::vector<MenuItemData> g_modelList;
 
-// 刷新菜单数据
+// 刷新菜单数据（模型库未变化时直接复用上次结果）
 void updateMenuLists() {
+    static uint32_t builtGeneration = 0;
+    if (builtGeneration == g_modelDatabase.generation()) return;
+    builtGeneration = g_modelDatabase.generation();
+
     g_skinList.clear();
     g_modelList.clear();
 
     // 获取default皮肤和模型
-    if (!g_modelDatabase.contains("default") || !g_modelDatabase.contains("library")) return;
-    const auto& def = g_modelDatabase["default"];
-    if (!def.is_array() || def.size() < 2) return;
-    std::string currentSkin = def[0];
-    std::string currentModel = def[1];
-
-    const auto& lib = g_modelDatabase["library"];
+    uint32_t currentSkin = g_modelDatabase.currentSkinId();
+    if (currentSkin == ModelDatabase::INVALID_ID) return;
+    uint32_t currentModel = g_modelDatabase.currentModelId();
 
     // 皮肤列表（除当前皮肤）
-    for (auto it = lib.begin(); it != lib.end(); ++it) {
-        std::string skinName = it.key();
-        if (skinName == currentSkin) continue;
-        std::string headPath;
-        if (it.value().contains("head")) {
-            headPath = it.value()["head"].get<std::string>();
-        }
-        g_skinList.push_back({ skinName, headPath, skinName });
+    g_skinList.reserve(g_modelDatabase.skinCount());
+    for (uint32_t id = 0; id < g_modelDatabase.skinCount(); ++id) {
+        if (id == currentSkin) continue;
+        const SkinRecord& skin = g_modelDatabase.skin(id);
+        g_skinList.push_back({ skin.name, skin.head, skin.name });
     }
 
-    // 模型列表（当前皮肤下所有模型，除head、非对象、当前模型）
-    if (lib.contains(currentSkin)) {
-        const auto& skinObj = lib[currentSkin];
-        for (auto it = skinObj.begin(); it != skinObj.end(); ++it) {
-            std::string modelName = it.key();
-            if (modelName == "head" || modelName == currentModel) continue;
-            if (!it.value().is_object()) continue;
-            std::string pngPath;
-            if (it.value().contains("png")) {
-                pngPath = it.value()["png"].get<std::string>();
-            }
-            g_modelList.push_back({ modelName, pngPath, modelName });
-        }
+    // 模型列表（当前皮肤下除当前模型外的所有模型）
+    const auto& models = g_modelDatabase.skin(currentSkin).models;
+    for (uint32_t id = 0; id < models.size(); ++id) {
+        if (id == currentModel) continue;
+        g_modelList.push_back({ models[id].name, models[id].png, models[id].name });
     }
 }
 
 // 声明全局退出标志
 bool g_appShouldExit = false;
 
+// 菜单线程投递给主循环的任务
+static std::mutex menuTaskMutex;
+static std::vector<std::function<void()>> menuTasks;
+
+void postMenuTask(std::function<void()> task) {
+    std::lock_guard lock(menuTaskMutex);
+    menuTasks.push_back(std::move(task));
+}
+
+void runMenuTasks() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard lock(menuTaskMutex);
+        tasks.swap(menuTasks);
+    }
+    for (auto& task : tasks) task();
+}
+
 // 动态生成皮肤子菜单项
 std::vector<MenuEntry> getCurrentSkinEntries(SkinCallback skinCb) {
     updateMenuLists();
     std::vector<MenuEntry> skinEntries;
     for (const auto& item : g_skinList) {
         // 只生成 Action 类型，callback 必须有效
+        // 菜单线程触发，转交主循环执行（主循环同时在重建模型库）
         skinEntries.push_back(MenuEntry::Action(item.text, item.iconPath, [skinCb, v = item.value]() {
-            if (skinCb) skinCb(v);
+            if (skinCb) postMenuTask([skinCb, v] { skinCb(v); });
         }));
     }
     return skinEntries;
@@ -89,7 +95,7 @@ std::vector<MenuEntry> getCurrentModelEntries(ModelCallback modelCb) {
     for (const auto& item : g_modelList) {
         // 只生成 Action 类型，callback 必须有效
         modelEntries.push_back(MenuEntry::Action(item.text, item.iconPath, [modelCb, v = item.value]() {
-            if (modelCb) modelCb(v);
+            if (modelCb) postMenuTask([modelCb, v] { modelCb(v); });
         }));
     }
     return modelEntries;
@@ -159,49 +165,14 @@ MenuModel buildMenuModel(
     return model;
 }
 
-// 工具函数：切换皮肤并自动选择模型
+// 工具函数：切换皮肤并自动选择模型（首选模型在加载模型库时已算好）
 void switchSkin(const std::string& skinName) {
-    if (!g_modelDatabase.contains("library")) return;
-    const auto& lib = g_modelDatabase["library"];
-    if (!lib.contains(skinName)) return;
-    const auto& skinObj = lib[skinName];
-
-    // 1. 同名
-    if (skinObj.contains(skinName)) {
-        g_modelDatabase["default"][0] = skinName;
-        g_modelDatabase["default"][1] = skinName;
-        return;
-    }
-    // 2. 默认
-    if (skinObj.contains("默认")) {
-        g_modelDatabase["default"][0] = skinName;
-        g_modelDatabase["default"][1] = "默认";
-        return;
-    }
-    // 3. 基建
-    if (skinObj.contains("基建")) {
-        g_modelDatabase["default"][0] = skinName;
-        g_modelDatabase["default"][1] = "基建";
-        return;
-    }
-    // 4. 正面
-    if (skinObj.contains("正面")) {
-        g_modelDatabase["default"][0] = skinName;
-        g_modelDatabase["default"][1] = "正面";
-        return;
-    }
-    // 5. 取第一个模型（排除head）
-    for (auto it = skinObj.begin(); it != skinObj.end(); ++it) {
-        if (it.key() == "head") continue;
-        g_modelDatabase["default"][0] = skinName;
-        g_modelDatabase["default"][1] = it.key();
-        return;
-    }
+    g_modelDatabase.selectSkin(skinName);
 }
 
 // 工具函数：切换模型
 void switchModel(const std::string& modelName) {
-    g_modelDatabase["default"][1] = modelName;
+    g_modelDatabase.selectModel(modelName);
 }
 
 // 默认菜单模型初始化函数，main.cpp 只需调用此函数即可
@@ -240,23 +211,11 @@ MenuModel getDefaultMenuModel() {
         },
         [] {
             printf(CONSOLE_BRIGHT_GREEN "[MENU] 位置锁定: 开" CONSOLE_RESET "\n");
-            extern void setWalkEnabled(bool);
-            setWalkEnabled(false);
-            extern void setGravityEnabled(bool);
-            setGravityEnabled(false);
-            extern WindowPhysicsState g_windowPhysicsState;
-            g_windowPhysicsState.locked = true;
+            setPositionLocked(true);
         },
         [] {
             printf(CONSOLE_BRIGHT_GREEN "[MENU] 位置锁定: 关" CONSOLE_RESET "\n");
-            extern void setWalkEnabled(bool);
-            setWalkEnabled(true);
-            extern void setGravityEnabled(bool);
-            setGravityEnabled(true);
-            extern WindowPhysicsState g_windowPhysicsState;
-            g_windowPhysicsState.locked = false;
-            g_windowPhysicsState.vx = 0.0f;
-            g_windowPhysicsState.vy = 0.0f;
+            setPositionLocked(false);
         },
         [] {
             printf(CONSOLE_BRIGHT_GREEN "[MENU] 键盘字母: 开" CONSOLE_RESET "\n");
@@ -266,27 +225,29 @@ MenuModel getDefaultMenuModel() {
             printf(CONSOLE_BRIGHT_GREEN "[MENU] 键盘字母: 关" CONSOLE_RESET "\n");
             hideSubtitleWindow();
         },
-        [](int state){
-            extern SpineAnimation* animSystem;
-            switch (state) {
-                case 1:
-                    printf(CONSOLE_BRIGHT_GREEN "[MENU] 目前状态: 坐" CONSOLE_RESET "\n");
-                    if (animSystem) {
-                        animSystem->playTemp("Sit", true);
-                    } break;
-                case 2:
-                    printf(CONSOLE_BRIGHT_GREEN "[MENU] 目前状态: 卧" CONSOLE_RESET "\n");
-                    if (animSystem) {
-                        animSystem->playTemp("Sleep", true);
-                    } break;
-                default:
-                    printf(CONSOLE_BRIGHT_GREEN "[MENU] 目前状态: 行" CONSOLE_RESET "\n");
-                    if (animSystem) {
-                        if (animSystem->isPlayingTemp()) {
-                            animSystem->playTemp("Interact");
+        [](int state) {
+            postMenuTask([state] {
+                extern SpineAnimation* animSystem;
+                switch (state) {
+                    case 1:
+                        printf(CONSOLE_BRIGHT_GREEN "[MENU] 目前状态: 坐" CONSOLE_RESET "\n");
+                        if (animSystem) {
+                            animSystem->playTemp("Sit", true);
+                        } break;
+                    case 2:
+                        printf(CONSOLE_BRIGHT_GREEN "[MENU] 目前状态: 卧" CONSOLE_RESET "\n");
+                        if (animSystem) {
+                            animSystem->playTemp("Sleep", true);
+                        } break;
+                    default:
+                        printf(CONSOLE_BRIGHT_GREEN "[MENU] 目前状态: 行" CONSOLE_RESET "\n");
+                        if (animSystem) {
+                            if (animSystem->isPlayingTemp()) {
+                                animSystem->playTemp("Interact");
+                            }
                         }
-                    }
-            }
+                }
+            });
         },
         [] {
             printf(CONSOLE_BRIGHT_GREEN "[MENU] 桌宠收纳" CONSOLE_RESET "\n");
@@ -308,11 +269,13 @@ MenuModel getDefaultMenuModel() {
         },
         [] {
             printf(CONSOLE_BRIGHT_GREEN "[MENU] 占位符喵" CONSOLE_RESET "\n");
-            extern SpineAnimation* animSystem;
-            if (animSystem) {
-                animSystem->playTemp("Interact");
-            }
-            g_showGlowEffect = true;
+            postMenuTask([] {
+                extern SpineAnimation* animSystem;
+                if (animSystem) {
+                    animSystem->playTemp("Interact");
+                }
+                g_showGlowEffect = true;
+            });
         },
         [] {
             printf(CONSOLE_BRIGHT_GREEN "[MENU] 销毁退出" CONSOLE_RESET "\n");
@@ -42,6 +42,11 @@ MenuModel getDefaultMenuModel();
 std::vector<MenuEntry> getCurrentSkinEntries(SkinCallback skinCb);
 std::vector<MenuEntry> getCurrentModelEntries(ModelCallback modelCb);
 
+// 菜单回调在菜单线程触发，涉及模型库和动画系统的部分投递到主循环执行
+void postMenuTask(std::function<void()> task);
+// 主循环每帧调用一次
+void runMenuTasks();
+
 // 全局回调（供菜单弹出时使用）
 extern SkinCallback g_skinCallback;
 extern ModelCallback g_modelCallback;
@@ -0,0 +1,51 @@
+#include <cwctype>
+#include <mutex>
+#include <unordered_map>
+#include <windows.h>
+
+#include "menu_search.h"
+#include "pinyin_initial.h"
+
+// 单个汉字的拼音首字母（GB2312以外的字符返回0）
+static char pinyinInitial(wchar_t ch) {
+    char gb[2] = {};
+    if (WideCharToMultiByte(936, 0, &ch, 1, gb, 2, nullptr, nullptr) != 2) return 0;
+    return gbPinyinInitial(static_cast<unsigned short>(static_cast<unsigned char>(gb[0]) << 8 | static_cast<unsigned char>(gb[1])));
+}
+
+std::string asciiLower(std::string_view text) {
+    std::string out(text);
+    for (char& c : out) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return out;
+}
+
+static MenuSearchKey buildSearchKey(const std::string& text) {
+    MenuSearchKey key{ asciiLower(text), {} };
+    int len = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+    std::wstring wide(static_cast<size_t>(len), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), wide.data(), len);
+    for (wchar_t ch : wide) {
+        if (ch < 0x80) {
+            if (iswalnum(ch)) key.initials.push_back(static_cast<char>(towlower(ch)));
+        } else if (char initial = pinyinInitial(ch)) {
+            key.initials.push_back(initial);
+        }
+    }
+    return key;
+}
+
+const MenuSearchKey& menuSearchKey(const std::string& text) {
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::string, MenuSearchKey> cache;
+    std::lock_guard lock(cacheMutex);
+    auto it = cache.find(text);
+    if (it == cache.end()) it = cache.emplace(text, buildSearchKey(text)).first;
+    return it->second;
+}
+
+bool menuSearchMatch(const MenuSearchKey& key, std::string_view query) {
+    if (query.empty()) return true;
+    return key.lower.find(query) != std::string::npos || key.initials.find(query) != std::string::npos;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// 菜单筛选索引项：同一名称只生成一次，之后每次弹出直接复用
+struct MenuSearchKey {
+    std::string lower;     // 原文（ASCII转小写）
+    std::string initials;  // 拼音首字母串，如 "阿米娅" → "amy"（非汉字的字母数字原样保留）
+};
+
+// 获取名称的筛选索引项（进程内缓存，返回的引用长期有效）
+const MenuSearchKey& menuSearchKey(const std::string& text);
+
+// 名称或拼音首字母包含查询串即视为命中（query 需已转小写）
+bool menuSearchMatch(const MenuSearchKey& key, std::string_view query);
+
+// ASCII转小写（中文等多字节字符不变）
+std::string asciiLower(std::string_view text);
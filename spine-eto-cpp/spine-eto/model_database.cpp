@@ -0,0 +1,121 @@
+#include "model_database.h"
+
+// 切换皮肤时按此顺序选择模型，均不存在时取第一个
+static const char* const kPreferredModels[] = { "默认", "基建", "正面" };
+
+// 读取字符串字段，缺失或类型不对时为空
+static std::string stringField(const nlohmann::json& obj, const char* key) {
+    auto it = obj.find(key);
+    return it != obj.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+void ModelDatabase::load(const nlohmann::json& package) {
+    m_skins.clear();
+    m_skinIds.clear();
+    m_currentSkin = INVALID_ID;
+    m_currentModel = INVALID_ID;
+    m_fileSkin.clear();
+    m_fileModel.clear();
+    ++m_generation;
+
+    auto lib = package.find("library");
+    if (lib == package.end() || !lib->is_object()) return;
+
+    m_skins.reserve(lib->size());
+    for (auto it = lib->begin(); it != lib->end(); ++it) {
+        if (!it.value().is_object()) continue;
+        SkinRecord skin;
+        skin.name = it.key();
+        skin.head = stringField(it.value(), "head");
+        for (auto mt = it.value().begin(); mt != it.value().end(); ++mt) {
+            if (mt.key() == "head" || !mt.value().is_object()) continue;
+            skin.modelIds.emplace(mt.key(), static_cast<uint32_t>(skin.models.size()));
+            skin.models.push_back({ mt.key(), stringField(mt.value(), "png"),
+                stringField(mt.value(), "skel"), stringField(mt.value(), "atlas") });
+        }
+
+        // 预先算好首选模型：同名→默认→基建→正面→第一个
+        skin.preferredModel = skin.models.empty() ? INVALID_ID : 0;
+        if (auto same = skin.modelIds.find(skin.name); same != skin.modelIds.end()) {
+            skin.preferredModel = same->second;
+        } else {
+            for (const char* name : kPreferredModels) {
+                if (auto found = skin.modelIds.find(name); found != skin.modelIds.end()) {
+                    skin.preferredModel = found->second;
+                    break;
+                }
+            }
+        }
+
+        m_skinIds.emplace(skin.name, static_cast<uint32_t>(m_skins.size()));
+        m_skins.push_back(std::move(skin));
+    }
+
+    auto def = package.find("default");
+    if (def == package.end() || !def->is_array() || def->size() < 2) return;
+    if (!(*def)[0].is_string() || !(*def)[1].is_string()) return;
+    m_fileSkin = (*def)[0].get<std::string>();
+    m_fileModel = (*def)[1].get<std::string>();
+    m_currentSkin = findSkin(m_fileSkin);
+    m_currentModel = findModel(m_currentSkin, m_fileModel);
+}
+
+bool ModelDatabase::reload(const nlohmann::json& package) {
+    std::string oldSkin = m_currentSkin < m_skins.size() ? m_skins[m_currentSkin].name : std::string();
+    const ModelRecord* oldCurrent = currentModel();
+    ModelRecord oldModel = oldCurrent ? *oldCurrent : ModelRecord{};
+    std::string oldFileSkin = m_fileSkin, oldFileModel = m_fileModel;
+
+    load(package);
+
+    // 外部只改了模型库内容时，保持菜单里切换后的皮肤和模型
+    if (oldCurrent && m_fileSkin == oldFileSkin && m_fileModel == oldFileModel) {
+        uint32_t skinId = findSkin(oldSkin);
+        uint32_t modelId = findModel(skinId, oldModel.name);
+        if (modelId != INVALID_ID) {
+            m_currentSkin = skinId;
+            m_currentModel = modelId;
+        }
+    }
+
+    // 新的选择无效时不重新加载，保留正在显示的模型
+    const ModelRecord* current = currentModel();
+    if (!current) return false;
+    return !oldCurrent || m_skins[m_currentSkin].name != oldSkin || current->name != oldModel.name ||
+        current->skel != oldModel.skel || current->atlas != oldModel.atlas;
+}
+
+uint32_t ModelDatabase::findSkin(const std::string& name) const {
+    auto it = m_skinIds.find(name);
+    return it == m_skinIds.end() ? INVALID_ID : it->second;
+}
+
+uint32_t ModelDatabase::findModel(uint32_t skinId, const std::string& name) const {
+    if (skinId >= m_skins.size()) return INVALID_ID;
+    const auto& ids = m_skins[skinId].modelIds;
+    auto it = ids.find(name);
+    return it == ids.end() ? INVALID_ID : it->second;
+}
+
+const ModelRecord* ModelDatabase::currentModel() const {
+    if (m_currentSkin >= m_skins.size()) return nullptr;
+    const auto& models = m_skins[m_currentSkin].models;
+    return m_currentModel < models.size() ? &models[m_currentModel] : nullptr;
+}
+
+bool ModelDatabase::selectSkin(const std::string& skinName) {
+    uint32_t skinId = findSkin(skinName);
+    if (skinId == INVALID_ID || m_skins[skinId].preferredModel == INVALID_ID) return false;
+    m_currentSkin = skinId;
+    m_currentModel = m_skins[skinId].preferredModel;
+    ++m_generation;
+    return true;
+}
+
+bool ModelDatabase::selectModel(const std::string& modelName) {
+    uint32_t modelId = findModel(m_currentSkin, modelName);
+    if (modelId == INVALID_ID) return false;
+    m_currentModel = modelId;
+    ++m_generation;
+    return true;
+}
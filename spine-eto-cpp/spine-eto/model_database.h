@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "json.hpp"
+
+// 模型（皮肤下的一个姿态，如 "基建"、"正面"），路径在加载时缓存
+struct ModelRecord {
+    std::string name;
+    std::string png;
+    std::string skel;
+    std::string atlas;
+};
+
+// 皮肤：头像路径、模型列表和按名称的索引
+struct SkinRecord {
+    std::string name;
+    std::string head;
+    std::vector<ModelRecord> models;
+    std::unordered_map<std::string, uint32_t> modelIds;
+    uint32_t preferredModel = 0; // 切换到该皮肤时默认选中的模型（同名→默认→基建→正面→第一个）
+};
+
+// package.json 的类型化索引：解析一次，皮肤和模型以序号标识，查询均为哈希查找或下标访问
+class ModelDatabase {
+public:
+    static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+    // 从 package.json 内容构建索引（library 保持 json 中的顺序），default 指定当前皮肤和模型
+    void load(const nlohmann::json& package);
+
+    // 文件变化后重新加载：文件中的 default 未变时保留运行中的选择
+    // 返回当前模型是否变化（皮肤、模型或其路径），需要重新加载Spine模型
+    bool reload(const nlohmann::json& package);
+
+    [[nodiscard]] uint32_t findSkin(const std::string& name) const;
+    [[nodiscard]] uint32_t findModel(uint32_t skinId, const std::string& name) const;
+
+    [[nodiscard]] size_t skinCount() const { return m_skins.size(); }
+    [[nodiscard]] const SkinRecord& skin(uint32_t skinId) const { return m_skins[skinId]; }
+
+    [[nodiscard]] uint32_t currentSkinId() const { return m_currentSkin; }
+    [[nodiscard]] uint32_t currentModelId() const { return m_currentModel; }
+    // 当前模型，default 无效时为 nullptr
+    [[nodiscard]] const ModelRecord* currentModel() const;
+
+    // 切换皮肤（自动选中该皮肤的首选模型），皮肤不存在或没有模型时返回 false
+    bool selectSkin(const std::string& skinName);
+    // 切换当前皮肤下的模型
+    bool selectModel(const std::string& modelName);
+
+    // 每次加载或切换后递增，供缓存判断是否需要重建
+    [[nodiscard]] uint32_t generation() const { return m_generation; }
+
+private:
+    std::vector<SkinRecord> m_skins;
+    std::unordered_map<std::string, uint32_t> m_skinIds;
+    uint32_t m_currentSkin = INVALID_ID;
+    uint32_t m_currentModel = INVALID_ID;
+    uint32_t m_generation = 0;
+
+    // 文件中 default 指定的皮肤和模型名
+    std::string m_fileSkin;
+    std::string m_fileModel;
+};
+
+// 全局模型库（main.cpp 读取 package.json 后加载）
+extern ModelDatabase g_modelDatabase;
@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <set>
+#include <string_view>
+#include <thread>
+
+#include "content_hash.h"
+#include "model_scanner.h"
+
+namespace fs = std::filesystem;
+
+// ---- skel / atlas 校验 ----
+
+// Spine 二进制的变长整数（每字节7位，低位在前）
+static bool readVarint(const unsigned char*& p, const unsigned char* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p >= end) return false;
+        unsigned char b = *p++;
+        value |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Spine 二进制字符串：长度+1 的变长整数，0 表示空
+static bool readSpineString(const unsigned char*& p, const unsigned char* end, std::string& out) {
+    uint32_t length = 0;
+    if (!readVarint(p, end, length) || length == 0 || length - 1 > static_cast<size_t>(end - p)) return false;
+    out.assign(reinterpret_cast<const char*>(p), length - 1);
+    p += length - 1;
+    return true;
+}
+
+static bool looksLikeVersion(const std::string& text) {
+    return !text.empty() && text.size() < 16 && std::isdigit(static_cast<unsigned char>(text[0])) &&
+        text.find('.') != std::string::npos &&
+        std::all_of(text.begin(), text.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) || c == '.'; });
+}
+
+// 从 skel 文件头读取 Spine 版本号，不是 skel 时返回空
+static std::string sniffSkelVersion(const std::vector<char>& data) {
+    const auto* begin = reinterpret_cast<const unsigned char*>(data.data());
+    const unsigned char* end = begin + data.size();
+    std::string hash, version;
+
+    // 3.x：哈希字符串 + 版本字符串
+    const unsigned char* p = begin;
+    if (readSpineString(p, end, hash) && readSpineString(p, end, version) && looksLikeVersion(version)) return version;
+    // 4.x：8字节哈希 + 版本字符串
+    p = begin + std::min<size_t>(8, data.size());
+    if (readSpineString(p, end, version) && looksLikeVersion(version)) return version;
+    return {};
+}
+
+static std::string trimLine(std::string_view line) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) return {};
+    size_t last = line.find_last_not_of(" \t\r");
+    return std::string(line.substr(first, last - first + 1));
+}
+
+// atlas 页面名：不含冒号、且下一条非空行以 "size:" 开头的行
+static std::vector<std::string> atlasPages(const std::vector<char>& data) {
+    std::vector<std::string> lines;
+    std::string_view text(data.data(), data.size());
+    while (!text.empty()) {
+        size_t eol = text.find('\n');
+        std::string line = trimLine(text.substr(0, eol));
+        if (!line.empty()) lines.push_back(std::move(line));
+        text = eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1);
+    }
+    std::vector<std::string> pages;
+    for (size_t i = 0; i + 1 < lines.size(); ++i) {
+        if (lines[i].find(':') == std::string::npos && lines[i + 1].starts_with("size:")) pages.push_back(lines[i]);
+    }
+    return pages;
+}
+
+// ---- 扫描 ----
+
+enum class FileKind { Skel, Atlas, Page };
+
+struct ScanTask {
+    std::string operatorName, skin, model;
+    fs::path dir;
+};
+
+struct ScanContext {
+    fs::path baseDir;
+    const ScanCache& cache;
+    std::atomic<size_t> hashed{0};
+    std::atomic<size_t> cached{0};
+};
+
+// 读取单个文件：大小和修改时间未变时取缓存，否则读取、哈希并解析元信息
+static bool scanFile(ScanContext& ctx, const fs::path& path, FileKind kind, ScannedFile& out) {
+    std::error_code ec;
+    out.path = "./" + pathToUtf8(fs::relative(path, ctx.baseDir, ec));
+    out.size = fs::file_size(path, ec);
+    if (ec) return false;
+    out.mtime = static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+    if (ec) return false;
+
+    auto it = ctx.cache.find(out.path);
+    if (it != ctx.cache.end() && it->second.size == out.size && it->second.mtime == out.mtime) {
+        out.hash = it->second.hash;
+        out.meta = it->second.meta;
+        out.fromCache = true;
+        ++ctx.cached;
+        return true;
+    }
+
+    std::vector<char> data;
+    if (!readWholeFile(path, data)) return false;
+    out.hash = contentHash(data.data(), data.size());
+    if (kind == FileKind::Skel) {
+        out.meta = sniffSkelVersion(data);
+    } else if (kind == FileKind::Atlas) {
+        for (const auto& page : atlasPages(data)) out.meta += page + '\n';
+    }
+    ++ctx.hashed;
+    return true;
+}
+
+static void scanModel(ScanContext& ctx, const ScanTask& task, ScannedModel& out) {
+    out.operatorName = task.operatorName;
+    out.skin = task.skin;
+    out.model = task.model;
+
+    std::vector<fs::path> skels, atlases;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(task.dir, ec)) {
+        if (!entry.is_regular_file()) continue;
+        auto ext = entry.path().extension();
+        if (ext == ".skel") skels.push_back(entry.path());
+        if (ext == ".atlas") atlases.push_back(entry.path());
+    }
+    if (skels.size() != 1 || atlases.size() != 1) {
+        out.error = "需要恰好一个 .skel 和一个 .atlas";
+        return;
+    }
+
+    if (!scanFile(ctx, skels[0], FileKind::Skel, out.skel) || !scanFile(ctx, atlases[0], FileKind::Atlas, out.atlas)) {
+        out.error = "文件读取失败";
+        return;
+    }
+    if (out.skel.meta.empty()) {
+        out.error = "skel 文件头无法识别";
+        return;
+    }
+    if (out.atlas.meta.empty()) {
+        out.error = "atlas 中没有页面";
+        return;
+    }
+
+    std::string_view pages = out.atlas.meta;
+    while (!pages.empty()) {
+        size_t eol = pages.find('\n');
+        std::string page(pages.substr(0, eol));
+        pages = eol == std::string_view::npos ? std::string_view{} : pages.substr(eol + 1);
+        ScannedFile file;
+        if (!scanFile(ctx, task.dir / utf8ToPath(page), FileKind::Page, file)) {
+            out.error = "缺少 atlas 页面: " + page;
+            return;
+        }
+        out.pages.push_back(std::move(file));
+    }
+}
+
+ScanReport scanModelLibrary(const fs::path& modelsDir, const fs::path& baseDir, const ScanCache& cache, unsigned threads) {
+    ScanReport report;
+    std::vector<ScanTask> tasks;
+    std::error_code ec;
+
+    // 目录遍历很快，单线程收集任务；读取和哈希放进线程池
+    for (const auto& op : fs::directory_iterator(modelsDir, ec)) {
+        if (!op.is_directory()) continue;
+        std::string operatorName = pathToUtf8(op.path().filename());
+
+        for (const auto& head : fs::directory_iterator(op.path() / "head", ec)) {
+            if (head.is_regular_file() && head.path().extension() == ".png") {
+                report.heads[operatorName + "/" + pathToUtf8(head.path().stem())] =
+                    "./" + pathToUtf8(fs::relative(head.path(), baseDir, ec));
+            }
+        }
+        for (const auto& skin : fs::directory_iterator(op.path() / "spine", ec)) {
+            if (!skin.is_directory()) continue;
+            for (const auto& model : fs::directory_iterator(skin.path(), ec)) {
+                if (!model.is_directory()) continue;
+                tasks.push_back({ operatorName, pathToUtf8(skin.path().filename()), pathToUtf8(model.path().filename()), model.path() });
+            }
+        }
+    }
+
+    ScanContext ctx{ baseDir, cache };
+    report.models.resize(tasks.size());
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<unsigned>(threads, static_cast<unsigned>(std::max<size_t>(tasks.size(), 1)));
+
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next++; i < tasks.size(); i = next++) scanModel(ctx, tasks[i], report.models[i]);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    report.hashedFiles = ctx.hashed;
+    report.cachedFiles = ctx.cached;
+    return report;
+}
+
+// ---- 缓存 ----
+
+bool loadScanCache(const fs::path& path, ScanCache& cache) {
+    std::ifstream file(path);
+    if (!file) return false;
+    auto data = nlohmann::json::parse(file, nullptr, false);
+    if (data.is_discarded() || !data.is_object()) return false;
+    cache.clear();
+    for (const auto& [key, value] : data.items()) {
+        // 缓存损坏或格式不符的条目直接丢弃，重新计算哈希即可
+        if (!value.is_array() || value.size() != 4 || !value[0].is_number_unsigned() || !value[1].is_number_integer() ||
+            !value[2].is_string() || !value[3].is_string()) {
+            continue;
+        }
+        ScannedFile entry;
+        entry.path = key;
+        entry.size = value[0].get<uint64_t>();
+        entry.mtime = value[1].get<int64_t>();
+        entry.hash = hashFromHex(value[2].get<std::string>());
+        entry.meta = value[3].get<std::string>();
+        cache.emplace(key, std::move(entry));
+    }
+    return true;
+}
+
+bool saveScanCache(const fs::path& path, const ScanCache& cache) {
+    nlohmann::json data = nlohmann::json::object();
+    for (const auto& [key, entry] : cache) {
+        data[key] = { entry.size, entry.mtime, hashToHex(entry.hash), entry.meta };
+    }
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+    file << data.dump();
+    return static_cast<bool>(file);
+}
+
+void updateScanCache(ScanCache& cache, const ScanReport& report) {
+    cache.clear();
+    auto keep = [&](const ScannedFile& file) {
+        if (!file.path.empty()) cache[file.path] = file;
+    };
+    for (const auto& model : report.models) {
+        keep(model.skel);
+        keep(model.atlas);
+        for (const auto& page : model.pages) keep(page);
+    }
+}
+
+std::vector<DuplicateGroup> findDuplicateFiles(const ScanReport& report) {
+    // 同一文件可能被多个模型引用，按路径去重后再按内容分组
+    std::map<std::pair<uint64_t, uint64_t>, std::set<std::string>> byContent;
+    auto add = [&](const ScannedFile& file) {
+        if (file.size > 0) byContent[{ file.hash, file.size }].insert(file.path);
+    };
+    for (const auto& model : report.models) {
+        if (!model.error.empty()) continue;
+        add(model.skel);
+        add(model.atlas);
+        for (const auto& page : model.pages) add(page);
+    }
+
+    std::vector<DuplicateGroup> groups;
+    for (auto& [key, paths] : byContent) {
+        if (paths.size() < 2) continue;
+        groups.push_back({ key.first, key.second, { paths.begin(), paths.end() } });
+    }
+    std::sort(groups.begin(), groups.end(), [](const DuplicateGroup& a, const DuplicateGroup& b) {
+        return a.size * (a.paths.size() - 1) > b.size * (b.paths.size() - 1);
+    });
+    return groups;
+}
+
+// ---- package.json ----
+
+nlohmann::json buildPackageLibrary(const ScanReport& report) {
+    // 同名皮肤出现在几个干员下
+    std::map<std::string, std::set<std::string>> skinOwners;
+    for (const auto& model : report.models) {
+        if (model.error.empty()) skinOwners[model.skin].insert(model.operatorName);
+    }
+
+    nlohmann::json library = nlohmann::json::object();
+    for (const auto& model : report.models) {
+        if (!model.error.empty()) continue;
+        std::string key = skinOwners[model.skin].size() > 1 ? model.operatorName + "·" + model.skin : model.skin;
+        auto& skin = library[key];
+        auto head = report.heads.find(model.operatorName + "/" + model.skin);
+        if (head != report.heads.end()) skin["head"] = head->second;
+        skin[model.model] = {
+            { "png", model.pages.front().path },
+            { "skel", model.skel.path },
+            { "atlas", model.atlas.path },
+        };
+    }
+    return library;
+}
+
+// 由条目中的模型路径（./models/<干员>/spine/<皮肤>/...）得到 "干员/皮肤"，无法识别时返回空
+static std::string skinOwner(const nlohmann::json& skin) {
+    if (!skin.is_object()) return {};
+    for (const auto& [model, value] : skin.items()) {
+        if (model == "head" || !value.is_object() || !value.contains("skel") || !value["skel"].is_string()) continue;
+        std::vector<std::string_view> parts;
+        std::string_view path = value["skel"].get_ref<const std::string&>();
+        for (size_t pos = 0; pos <= path.size();) {
+            size_t next = std::min(path.find('/', pos), path.size());
+            parts.push_back(path.substr(pos, next - pos));
+            pos = next + 1;
+        }
+        for (size_t i = 1; i + 1 < parts.size(); ++i) {
+            if (parts[i] == "spine") return std::string(parts[i - 1]) + "/" + std::string(parts[i + 1]);
+        }
+    }
+    return {};
+}
+
+void mergePackage(nlohmann::json& package, const nlohmann::json& library, bool replace) {
+    if (!package.is_object()) package = nlohmann::json::object();
+    if (replace || !package.contains("library") || !package["library"].is_object()) {
+        package["library"] = nlohmann::json::object();
+    }
+    auto& lib = package["library"];
+
+    // 同名皮肤增减时键会在 "皮肤" 和 "干员·皮肤" 间改名，先移除同一干员皮肤的旧键
+    std::map<std::string, std::string> renamedTo; // 旧键 → 新键
+    for (const auto& [key, value] : library.items()) {
+        std::string owner = skinOwner(value);
+        if (owner.empty()) continue;
+        for (const auto& [oldKey, oldValue] : lib.items()) {
+            if (oldKey != key && !library.contains(oldKey) && skinOwner(oldValue) == owner) renamedTo[oldKey] = key;
+        }
+    }
+    for (const auto& [oldKey, newKey] : renamedTo) lib.erase(oldKey);
+    for (const auto& [key, value] : library.items()) lib[key] = value;
+
+    if (package.contains("default") && package["default"].is_array() && !package["default"].empty() &&
+        package["default"][0].is_string()) {
+        auto renamed = renamedTo.find(package["default"][0].get<std::string>());
+        if (renamed != renamedTo.end()) package["default"][0] = renamed->second;
+    }
+
+    // default 仍指向有效模型时保留，否则取第一个皮肤的第一个模型
+    const auto& def = package.contains("default") ? package["default"] : nlohmann::json();
+    bool valid = def.is_array() && def.size() >= 2 && def[0].is_string() && def[1].is_string() &&
+        lib.contains(def[0].get<std::string>()) && lib[def[0].get<std::string>()].contains(def[1].get<std::string>());
+    if (valid) return;
+    for (const auto& [skin, models] : lib.items()) {
+        for (const auto& [model, value] : models.items()) {
+            if (model == "head" || !value.is_object()) continue;
+            package["default"] = { skin, model };
+            return;
+        }
+    }
+}
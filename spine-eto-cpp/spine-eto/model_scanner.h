@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "json.hpp"
+
+// 模型库扫描：遍历 models/<干员>/head/*.png 和 models/<干员>/spine/<皮肤>/<模型>/*.{atlas,skel,png}
+// 多线程校验（skel文件头、atlas页面引用）并计算内容哈希，生成或合并 package.json
+
+// 扫描到的文件（path 相对 package.json 所在目录，如 "./models/铃兰/..."）
+struct ScannedFile {
+    std::string path;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    uint64_t hash = 0;
+    std::string meta;       // skel 为版本号，atlas 为页面文件名（换行分隔）
+    bool fromCache = false; // 大小和修改时间未变，直接取自增量缓存
+};
+
+struct ScannedModel {
+    std::string operatorName;
+    std::string skin;
+    std::string model;
+    ScannedFile skel;
+    ScannedFile atlas;
+    std::vector<ScannedFile> pages;
+    std::string error; // 为空表示校验通过
+};
+
+struct ScanReport {
+    std::vector<ScannedModel> models;
+    std::map<std::string, std::string> heads; // "干员/皮肤" → 头像路径
+    size_t hashedFiles = 0;
+    size_t cachedFiles = 0;
+};
+
+// 增量缓存：路径 → 上次扫描结果
+using ScanCache = std::unordered_map<std::string, ScannedFile>;
+
+bool loadScanCache(const std::filesystem::path& path, ScanCache& cache);
+bool saveScanCache(const std::filesystem::path& path, const ScanCache& cache);
+// 用本次扫描结果替换缓存（已删除的文件随之移除）
+void updateScanCache(ScanCache& cache, const ScanReport& report);
+
+// 扫描模型目录，threads 为0时使用硬件线程数
+ScanReport scanModelLibrary(const std::filesystem::path& modelsDir, const std::filesystem::path& baseDir,
+    const ScanCache& cache, unsigned threads = 0);
+
+// 由扫描结果生成 library（皮肤名在多个干员下重复时键为 "干员·皮肤"）
+nlohmann::json buildPackageLibrary(const ScanReport& report);
+
+// 内容完全相同的一组文件（同一哈希、同一大小）
+struct DuplicateGroup {
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    std::vector<std::string> paths;
+};
+
+// 找出扫描结果中重复的 skel/atlas/png 文件，按浪费的字节数从大到小排列
+std::vector<DuplicateGroup> findDuplicateFiles(const ScanReport& report);
+
+// 合并到 package.json：replace 为 false 时保留未扫描到的条目；default 无效时改为第一个皮肤
+void mergePackage(nlohmann::json& package, const nlohmann::json& library, bool replace);
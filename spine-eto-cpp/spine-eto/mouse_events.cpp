@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdio>
 #include <windows.h>
 
@@ -17,6 +18,52 @@ extern WindowWorkArea g_workArea;
 
 MouseEventManager::MouseEventManager() = default;
 
+void VelocityEstimator::reset() {
+    head = 0;
+    count = 0;
+}
+
+void VelocityEstimator::push(double time, int x, int y) {
+    samples[head] = Sample{time, x, y};
+    head = (head + 1) % CAPACITY;
+    if (count < CAPACITY) ++count;
+}
+
+sf::Vector2f VelocityEstimator::estimate(double now, double window) const {
+    // 第一遍：加权均值（权重随样本年龄线性下降到0.5）
+    double sw = 0.0, st = 0.0, sx = 0.0, sy = 0.0;
+    double oldest = now, newest = now - window;
+    for (size_t i = 0; i < count; ++i) {
+        const Sample& s = samples[(head + CAPACITY - 1 - i) % CAPACITY];
+        double age = now - s.time;
+        if (age > window) break; // 从新到旧遍历，遇到过期即停止
+        double w = 1.0 - 0.5 * age / window;
+        sw += w;
+        st += w * s.time;
+        sx += w * s.x;
+        sy += w * s.y;
+        oldest = std::min(oldest, s.time);
+        newest = std::max(newest, s.time);
+    }
+    if (sw <= 0.0 || newest - oldest <= 0.01) return {0.f, 0.f};
+    double mt = st / sw, mx = sx / sw, my = sy / sw;
+
+    // 第二遍：斜率即速度
+    double stt = 0.0, stx = 0.0, sty = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const Sample& s = samples[(head + CAPACITY - 1 - i) % CAPACITY];
+        double age = now - s.time;
+        if (age > window) break;
+        double w = 1.0 - 0.5 * age / window;
+        double dt = s.time - mt;
+        stt += w * dt * dt;
+        stx += w * dt * (s.x - mx);
+        sty += w * dt * (s.y - my);
+    }
+    if (stt <= 1e-12) return {0.f, 0.f};
+    return {static_cast<float>(stx / stt), static_cast<float>(sty / stt)};
+}
+
 void setHandCursorWin(bool pressed) {
     static HCURSOR hHand = LoadCursor(nullptr, IDC_HAND);
     static HCURSOR hArrow = LoadCursor(nullptr, IDC_ARROW);
@@ -31,11 +78,8 @@ void setHandCursorWin(bool pressed) {
 }
 
 void MouseEventManager::handleEvent(const sf::Event& event, const sf::RenderWindow& window) {
-    static constexpr float minInterval = 0.2f; // 0.2秒输出一次
+    static constexpr float minInterval = 0.2f; // 速度估计的时间窗口
 
-    // 拖动累积
-    static sf::Vector2f accumulatedDelta(0.f, 0.f);
-    static float accumulatedTime = 0.f;
     static sf::Vector2i dragOffset; // 鼠标按下时窗口左上角到鼠标的偏移
 
     // 双击检测
@@ -54,15 +98,6 @@ void MouseEventManager::handleEvent(const sf::Event& event, const sf::RenderWind
     // 用全局工作区
     const WindowWorkArea& workArea = g_workArea;
 
-    // 用于计算最后minInterval秒的平均速度
-    struct WindowMoveSample {
-        double time;
-        int x, y;
-    };
-    static std::deque<WindowMoveSample> moveHistory;
-
-    static sf::Clock windowMoveClock;
-
     if (event.type == sf::Event::MouseButtonPressed) {
         if (event.mouseButton.button == sf::Mouse::Left) {
             // 检查双击
@@ -88,9 +123,7 @@ void MouseEventManager::handleEvent(const sf::Event& event, const sf::RenderWind
             dragState.lastPos = dragState.startPos;
             dragState.currentPos = dragState.startPos;
             dragState.dragClock.restart();
-            velocityClock.restart();
-            accumulatedDelta = sf::Vector2f(0.f, 0.f);
-            accumulatedTime = 0.f;
+            dragState.velocity = sf::Vector2f(0.f, 0.f);
 
             // 记录窗口左上角到鼠标的偏移
             RECT winRect;
@@ -102,8 +135,9 @@ void MouseEventManager::handleEvent(const sf::Event& event, const sf::RenderWind
             printf(CONSOLE_BRIGHT_CYAN "[INTERACT] Left Pressed @ (%d, %d)" CONSOLE_RESET "\n", pos.x, pos.y);
             setHandCursorWin(true); // 按下时抓手
 
-            // 拖动开始时，物理状态同步
+            // 拖动开始时，物理状态同步并唤醒
             physicsState.isDragging = true;
+            wakeWindowPhysics();
             // 拖动时速度清零，位置同步
             RECT rc;
             GetWindowRect(hwnd, &rc);
@@ -113,10 +147,8 @@ void MouseEventManager::handleEvent(const sf::Event& event, const sf::RenderWind
             physicsState.vy = 0.0f;
 
             // 拖动速度采样历史
-            moveHistory.clear();
-            // 显式类型转换，避免narrowing conversion
-            moveHistory.push_back(WindowMoveSample{0.0, static_cast<int>(rc.left), static_cast<int>(rc.top)});
-            windowMoveClock.restart();
+            velocityEstimator.reset();
+            velocityEstimator.push(0.0, static_cast<int>(rc.left), static_cast<int>(rc.top));
         } else if (event.mouseButton.button == sf::Mouse::Right) {
             sf::Vector2i pos = sf::Mouse::getPosition(window);
             printf(CONSOLE_BRIGHT_CYAN "[INTERACT] Right Pressed @ (%d, %d)" CONSOLE_RESET "\n", pos.x, pos.y);
@@ -135,36 +167,21 @@ void MouseEventManager::handleEvent(const sf::Event& event, const sf::RenderWind
             HWND hwnd = window.getSystemHandle();
             RECT rc;
             GetWindowRect(hwnd, &rc);
-            double now = windowMoveClock.getElapsedTime().asSeconds();
-
-            // 维护历史，插入当前
-            moveHistory.push_back(WindowMoveSample{now, static_cast<int>(rc.left), static_cast<int>(rc.top)});
-            // 移除minInterval前的点
-            while (!moveHistory.empty() && now - moveHistory.front().time > minInterval) {
-                moveHistory.pop_front();
-            }
+            double now = dragState.dragClock.getElapsedTime().asSeconds();
 
-            float velocityX = 0.0f, velocityY = 0.0f;
-            if (moveHistory.size() >= 2) {
-                auto& first = moveHistory.front();
-                auto& last = moveHistory.back();
-                double dt = last.time - first.time;
-                if (dt > 0.01) {
-                    velocityX = static_cast<float>(last.x - first.x) / static_cast<float>(dt);
-                    velocityY = static_cast<float>(last.y - first.y) / static_cast<float>(dt);
-                }
-            }
+            // 插入当前位置后拟合最近minInterval秒的速度
+            velocityEstimator.push(now, static_cast<int>(rc.left), static_cast<int>(rc.top));
+            sf::Vector2f velocity = velocityEstimator.estimate(now, minInterval);
+            dragState.velocity = velocity;
             printf(CONSOLE_BRIGHT_BLUE "[TOTAL] Move To (%d, %d)" CONSOLE_RESET "\n", pos.x, pos.y);
-            printf(CONSOLE_BRIGHT_YELLOW "[TOTAL] Velocity (%.2f, %.2f) px/s" CONSOLE_RESET "\n", velocityX, velocityY);
+            printf(CONSOLE_BRIGHT_YELLOW "[TOTAL] Velocity (%.2f, %.2f) px/s" CONSOLE_RESET "\n", velocity.x, velocity.y);
 
-            physicsState.vx = velocityX;
-            physicsState.vy = velocityY;
+            physicsState.vx = velocity.x;
+            physicsState.vy = velocity.y;
             physicsState.isDragging = false;
 
             setHandCursorWin(false); // 松开时恢复手型
-            accumulatedDelta = sf::Vector2f(0.f, 0.f);
-            accumulatedTime = 0.f;
-            moveHistory.clear();
+            velocityEstimator.reset();
         } else if (event.mouseButton.button == sf::Mouse::Right) {
             sf::Vector2i pos = sf::Mouse::getPosition(window);
             printf(CONSOLE_BRIGHT_CYAN "[INTERACT] Right Released @ (%d, %d)" CONSOLE_RESET "\n", pos.x, pos.y);
@@ -191,12 +208,12 @@ void MouseEventManager::handleEvent(const sf::Event& event, const sf::RenderWind
             physicsState.lastY = static_cast<float>(newTop);
 
             // 记录窗口移动用于速度计算
-            double now = windowMoveClock.getElapsedTime().asSeconds();
-            moveHistory.push_back(WindowMoveSample{now, newLeft, newTop});
-            // 保留minInterval内的历史
-            while (!moveHistory.empty() && now - moveHistory.front().time > minInterval) {
-                moveHistory.pop_front();
-            }
+            double now = dragState.dragClock.getElapsedTime().asSeconds();
+            velocityEstimator.push(now, newLeft, newTop);
+
+            sf::Vector2i newPos = sf::Mouse::getPosition(window);
+            dragState.lastPos = dragState.currentPos;
+            dragState.currentPos = newPos;
         }
 
         if (PtInRect(&rc, pt)) {
@@ -208,29 +225,6 @@ void MouseEventManager::handleEvent(const sf::Event& event, const sf::RenderWind
             SetCursor(LoadCursor(nullptr, IDC_ARROW));
         }
     }
-
-    if (event.type == sf::Event::MouseMoved && dragState.dragging) {
-        sf::Vector2i newPos = sf::Mouse::getPosition(window);
-        float dt = velocityClock.getElapsedTime().asSeconds();
-        int dx = newPos.x - dragState.lastPos.x;
-        int dy = newPos.y - dragState.lastPos.y;
-        if (dt > 0 && (dx != 0 || dy != 0)) {
-            accumulatedDelta.x += static_cast<float>(dx);
-            accumulatedDelta.y += static_cast<float>(dy);
-            accumulatedTime += dt;
-            dragState.lastPos = dragState.currentPos;
-            dragState.currentPos = newPos;
-            if (accumulatedTime >= minInterval) {
-                sf::Vector2f velocity = accumulatedDelta / accumulatedTime;
-                printf(CONSOLE_BRIGHT_BLUE "[STATE] Move To (%d, %d)" CONSOLE_RESET "\n", newPos.x, newPos.y);
-                printf(CONSOLE_BRIGHT_YELLOW "[STATE] Velocity (%.2f, %.2f) px/s" CONSOLE_RESET "\n", velocity.x, velocity.y);
-                dragState.velocity = velocity;
-                accumulatedDelta = sf::Vector2f(0.f, 0.f);
-                accumulatedTime = 0.f;
-            }
-            velocityClock.restart();
-        }
-    }
 }
 
 bool MouseEventManager::isDragging() const {
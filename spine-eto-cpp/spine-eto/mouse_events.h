@@ -2,6 +2,8 @@
 
 #include <SFML/Graphics.hpp>
 
+#include <array>
+
 enum class MouseButtonType { Left, Right, Other };
 
 struct DragState {
@@ -13,6 +15,25 @@ struct DragState {
     sf::Clock dragClock;
 };
 
+// 拖动速度估计：定长环形缓冲保存窗口位置，按时间窗口做加权最小二乘拟合
+class VelocityEstimator {
+public:
+    void reset();
+    void push(double time, int x, int y);
+    // 只使用 now 之前 window 秒内的样本，越新的样本权重越大
+    [[nodiscard]] sf::Vector2f estimate(double now, double window) const;
+
+private:
+    struct Sample {
+        double time;
+        int x, y;
+    };
+    static constexpr size_t CAPACITY = 64;
+    std::array<Sample, CAPACITY> samples{};
+    size_t head = 0;  // 下一个写入位置
+    size_t count = 0;
+};
+
 class MouseEventManager {
 public:
     MouseEventManager();
@@ -25,5 +46,5 @@ public:
 
 private:
     DragState dragState;
-    sf::Clock velocityClock;
+    VelocityEstimator velocityEstimator;
 };
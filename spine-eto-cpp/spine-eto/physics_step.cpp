@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cmath>
+
+#include "physics_step.h"
+
+// 子步参数
+constexpr float SUBSTEP_PIXELS = 8.0f;  // 单个子步的最大位移(px)
+constexpr int MAX_SUBSTEPS = 64;        // 子步数上限
+constexpr float TOP_BOUNCE_GRAVITY = 2.0f; // 顶部反弹加速度倍数
+
+// 单个子步内的连续碰撞：按最早碰撞时刻推进，接触后去掉法向速度再走完剩余时间
+static void sweepSubstep(float& x, float& y, WindowPhysicsState& state, const WindowWorkArea& area,
+                         float gravity, float h, WindowContacts& contacts) {
+    const auto minX = static_cast<float>(area.minX), maxX = static_cast<float>(area.maxX);
+    const auto minY = static_cast<float>(area.minY), maxY = static_cast<float>(area.maxY);
+
+    float remaining = h;
+    // 每次迭代至少消去一个方向的速度分量，四次足够
+    for (int iter = 0; iter < 4 && remaining > 0.0f; ++iter) {
+        float tHit = remaining;
+        int wall = -1; // 0=左 1=右 2=上 3=下
+        if (state.vx < 0.0f && (minX - x) / state.vx < tHit) { tHit = (minX - x) / state.vx; wall = 0; }
+        if (state.vx > 0.0f && (maxX - x) / state.vx < tHit) { tHit = (maxX - x) / state.vx; wall = 1; }
+        if (state.vy < 0.0f && (minY - y) / state.vy < tHit) { tHit = (minY - y) / state.vy; wall = 2; }
+        if (state.vy > 0.0f && (maxY - y) / state.vy < tHit) { tHit = (maxY - y) / state.vy; wall = 3; }
+        tHit = std::max(tHit, 0.0f);
+
+        x += state.vx * tHit;
+        y += state.vy * tHit;
+        remaining -= tHit;
+
+        switch (wall) {
+            case 0: x = minX; state.vx = 0.0f; contacts.left = true; break;
+            case 1: x = maxX; state.vx = 0.0f; contacts.right = true; break;
+            case 2:
+                y = minY;
+                state.vy = gravity * TOP_BOUNCE_GRAVITY * remaining; // 顶部反弹
+                contacts.top = true;
+                break;
+            case 3: y = maxY; state.vy = 0.0f; contacts.bottom = true; break;
+            default: remaining = 0.0f; break;
+        }
+    }
+}
+
+WindowContacts stepWindowPhysics(float& x, float& y, WindowPhysicsState& state, const WindowWorkArea& area, float gravity, float dt) {
+    WindowContacts contacts;
+
+    // 工作区变化后可能已在边界外，先拉回
+    x = std::clamp(x, static_cast<float>(area.minX), static_cast<float>(std::max(area.minX, area.maxX)));
+    y = std::clamp(y, static_cast<float>(area.minY), static_cast<float>(std::max(area.minY, area.maxY)));
+
+    // 子步数随本帧位移自适应：慢速一步完成，快速抛掷才细分
+    float travel = (std::abs(state.vx) + std::abs(state.vy) + gravity * dt) * dt;
+    int substeps = std::clamp(static_cast<int>(std::ceil(travel / SUBSTEP_PIXELS)), 1, MAX_SUBSTEPS);
+    float h = dt / static_cast<float>(substeps);
+
+    for (int i = 0; i < substeps; ++i) {
+        state.vy += gravity * h;
+        sweepSubstep(x, y, state, area, gravity, h, contacts);
+    }
+    return contacts;
+}
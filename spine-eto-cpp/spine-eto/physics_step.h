@@ -0,0 +1,29 @@
+#pragma once
+
+// 窗口物理的纯计算部分（不依赖 Win32），桌宠和 physics_test 共用
+
+// 物理状态
+struct WindowPhysicsState {
+    float vx = 0.0f;
+    float vy = 0.0f;
+    float lastX = 0.0f;
+    float lastY = 0.0f;
+    bool isDragging = false;
+    bool locked = false;
+    bool sleeping = false; // 静止休眠，休眠时不再步进物理
+};
+
+// 工作区信息
+struct WindowWorkArea {
+    int minX, maxX, minY, maxY;
+    int width, height;
+};
+
+// 边界接触标记
+struct WindowContacts {
+    bool left = false, right = false, top = false, bottom = false;
+};
+
+// 物理步进：按速度自适应子步，边界按精确碰撞时刻处理，结果始终在工作区内
+// gravity 为实际生效的重力加速度（关闭重力时传 0）
+WindowContacts stepWindowPhysics(float& x, float& y, WindowPhysicsState& state, const WindowWorkArea& area, float gravity, float dt);
@@ -0,0 +1,5 @@
+#pragma once
+
+// GB2312 汉字（高字节 << 8 | 低字节）的拼音首字母，覆盖一级和二级汉字，非汉字返回0
+// 不依赖 Win32，编码转换由调用方完成
+char gbPinyinInitial(unsigned short code);
@@ -1,9 +1,15 @@
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <utility>
 #include <windows.h>
 
 #include "console_colors.h"
+#include "icon_atlas.h"
+#include "menu_search.h"
 #include "right_click_menu.h"
 #include "spine_win_utils.h"
 #include "menu_model_utils.h"
@@ -59,21 +65,23 @@ private:
     std::size_t m_cornerPointCount;
 };
 
+class MenuWidget;
+static void resetFirstTriToggle(MenuWidget* root);
+
 // 菜单显示控件，递归支持子菜单和点击事件
 class MenuWidget {
 public:
-    MenuWidget(const std::vector<MenuEntry>& entries, const sf::Font& font)
-        : m_entries(entries), m_font(font), visible(false), hoverIndex(-1), parent(nullptr) {
-        // 递归生成子菜单控件
+    MenuWidget(const std::vector<MenuEntry>& entries, const sf::Font& font, MenuWidget* parentWidget = nullptr)
+        : m_entries(entries), m_font(font), visible(false), hoverIndex(-1), parent(parentWidget) {
+        // 递归生成子菜单控件（先确定parent，布局依赖是否为子菜单）
         for (const auto& entry : m_entries) {
             if (entry.type == MenuEntryType::SubMenu) {
-                auto sub = std::make_unique<MenuWidget>(entry.submenu, font);
-                sub->parent = this;
-                m_submenus.push_back(std::move(sub));
+                m_submenus.push_back(std::make_unique<MenuWidget>(entry.submenu, font, this));
             } else {
                 m_submenus.push_back(nullptr);
             }
         }
+        layout();
     }
 
     void setPosition(const sf::Vector2f& pos) { m_position = pos; }
@@ -81,24 +89,38 @@ public:
         setPosition(pos);
         visible = true;
         hoverIndex = -1;
+        m_dirty = true;
         // 隐藏所有子菜单
         for (auto& sub : m_submenus) if (sub) sub->hide();
     }
     void hide() {
+        if (visible) m_dirty = true;
         visible = false;
         hoverIndex = -1;
         for (auto& sub : m_submenus) if (sub) sub->hide();
     }
+
+    // 取出并清除整棵菜单树的重绘标记（悬停项、开关状态、子菜单显隐变化时置位）
+    bool takeDirty() {
+        bool dirty = m_dirty;
+        m_dirty = false;
+        for (auto& sub : m_submenus) {
+            if (sub && sub->takeDirty()) dirty = true;
+        }
+        return dirty;
+    }
     [[nodiscard]] bool isVisible() const { return visible; }
 
     // 鼠标事件处理
     bool handleEvent(const sf::Event& event, const sf::RenderWindow& window) {
         if (!visible) return false;
+        if (m_virtual && handleListEvent(event, window)) return true;
         bool consumed = false;
         if (event.type == sf::Event::MouseMoved) {
             sf::Vector2f mousePos = window.mapPixelToCoords({ event.mouseMove.x, event.mouseMove.y });
             int prevHover = hoverIndex;
             hoverIndex = getItemIndexAt(mousePos);
+            if (hoverIndex != prevHover) m_dirty = true;
 
             // 判断鼠标是否在某个子菜单区域内
             int submenuActive = -1;
@@ -120,12 +142,11 @@ public:
             for (size_t i = 0; i < m_entries.size(); ++i) {
                 if (m_entries[i].type == MenuEntryType::SubMenu && m_submenus[i]) {
                     if (static_cast<int>(i) == hoverIndex || static_cast<int>(i) == submenuActive) {
-                        // 打开子菜单前，先隐藏所有子菜单，保证只显示一个
-                        for (auto& sub : m_submenus) {
-                            if (sub) sub->hide();
+                        // 打开子菜单前，先隐藏其它子菜单，保证只显示一个（已显示的不重复打开）
+                        for (size_t j = 0; j < m_submenus.size(); ++j) {
+                            if (j != i && m_submenus[j]) m_submenus[j]->hide();
                         }
-                        sf::Vector2f subPos = getSubmenuPosition(i);
-                        m_submenus[i]->show(subPos);
+                        if (!m_submenus[i]->isVisible()) m_submenus[i]->show(getSubmenuPosition(i));
                         break; // 只显示一个
                     }
                 }
@@ -185,10 +206,8 @@ public:
 
     // 判断点是否在当前菜单区域内
     [[nodiscard]] bool isPointInMenu(const sf::Vector2f& pt) const {
-        float width = 200.f, height = 0.f, itemHeight = 32.f;
-        for (const auto& entry : m_entries)
-            height += (entry.type == MenuEntryType::Separator) ? 8.f : itemHeight;
-        sf::FloatRect rect(m_position.x, m_position.y, width, height);
+        // 宽度取自布局缓存，与绘制和 getItemIndexAt 一致
+        sf::FloatRect rect(m_position.x, m_position.y, m_width, contentHeight());
         if (rect.contains(pt)) return true;
         // 检查子菜单
         for (const auto& sub : m_submenus) {
@@ -202,80 +221,32 @@ public:
         float margin = 4.f, margin_d = 10.f;
         float itemHeight = 32.f, padding = 8.f;
 
-        // 判断是否是子菜单（有parent即为子菜单）
-        bool isSubMenu = parent != nullptr;
-
-        // 计算宽度
-        float width;
-        if (isSubMenu) {
-            float maxTextWidth = 0.f;
-            for (const auto& entry : m_entries) {
-                if (entry.type == MenuEntryType::Separator) continue;
-                sf::Text text;
-                text.setFont(m_font);
-                text.setCharacterSize(16);
-                text.setString(sf::String::fromUtf8(entry.text.begin(), entry.text.end()));
-                float textWidth = text.getLocalBounds().width;
-                float iconWidth = entry.iconPath.empty() ? 0.f : (32.f);
-                float toggleCircle = (entry.type == MenuEntryType::Toggle || entry.type == MenuEntryType::ToggleTri) ? 20.f : 0.f;
-                float totalWidth = padding + iconWidth + textWidth + toggleCircle + padding;
-                if (entry.type == MenuEntryType::SubMenu) totalWidth += 18.f;
-                if (totalWidth > maxTextWidth) maxTextWidth = totalWidth;
-            }
-            width = maxTextWidth + 4.f;
-        } else {
-            width = 135.f;
-        }
-
-        float height = 0.f;
-        for (const auto& entry : m_entries)
-            height += (entry.type == MenuEntryType::Separator) ? padding : itemHeight;
-        height += margin + margin_d;
+        // 宽高取自布局缓存
+        float width = m_width;
+        float height = contentHeight() + margin + margin_d;
 
         RoundedRectangleShape bg({ width + margin * 2, height }, 10.f, 12);
         bg.setFillColor(sf::Color(223, 223, 223, 255));
         bg.setPosition(m_position.x - margin, m_position.y - margin);
         target.draw(bg);
 
-        float y = m_position.y + margin;
+        if (m_virtual) {
+            drawList(target);
+            return;
+        }
+
         for (size_t i = 0; i < m_entries.size(); ++i) {
             const auto& entry = m_entries[i];
-            float iconSize = 24.f;
+            float y = m_position.y + margin + m_itemTop[i];
 
             if (entry.type == MenuEntryType::Separator) {
                 sf::RectangleShape line({ width - 2 * padding, 2.f });
                 line.setFillColor(sf::Color(159, 159, 159, 191));
                 line.setPosition(m_position.x + padding, y + 3);
                 target.draw(line);
-                y += 8.f;
                 continue;
             }
-            // 圆角高亮
-            if (static_cast<int>(i) == hoverIndex) {
-                float highlightRadius = 10.f;
-                RoundedRectangleShape hi({ width - 8, itemHeight - 2 }, highlightRadius, 8);
-                hi.setFillColor(sf::Color(191, 191, 191, 223));
-                hi.setPosition(m_position.x + 4, y + 1);
-                target.draw(hi);
-            }
-            // 图标（路径加载&缓存）
-            if (!entry.iconPath.empty()) {
-                sf::Texture& icon = getIcon(entry.iconPath);
-                sf::Sprite iconSprite(icon);
-                iconSprite.setScale(iconSize / icon.getSize().x, iconSize / icon.getSize().y);
-                iconSprite.setPosition(m_position.x + padding, y + (itemHeight - iconSize) / 2.f);
-                target.draw(iconSprite);
-            }
-            // 中文文本
-            if (entry.type != MenuEntryType::Separator) {
-                sf::Text text;
-                text.setFont(m_font);
-                text.setCharacterSize(16);
-                text.setFillColor(sf::Color::Black);
-                text.setString(sf::String::fromUtf8(entry.text.begin(), entry.text.end())); // 支持中文
-                text.setPosition(m_position.x + padding + (!entry.iconPath.empty() ? iconSize + 8.f : 0.f), y + (itemHeight - static_cast<float>(text.getCharacterSize())) / 2.f - 2.f);
-                target.draw(text);
-            }
+            drawItemBody(target, i, y);
             // 子菜单箭头
             if (entry.type == MenuEntryType::SubMenu) {
                 sf::ConvexShape arrow;
@@ -310,7 +281,6 @@ public:
                     circle.setFillColor(sf::Color::Transparent);
                 target.draw(circle);
             }
-            y += itemHeight;
         }
         // 绘制子菜单
         for (auto& sub : m_submenus) {
@@ -335,8 +305,7 @@ public:
         if (m_entries[idx].type != MenuEntryType::SubMenu) return;
         m_entries[idx].submenu = newEntries;
         if (m_submenus[idx]) {
-            m_submenus[idx] = std::make_unique<MenuWidget>(newEntries, m_font);
-            m_submenus[idx]->parent = this;
+            m_submenus[idx] = std::make_unique<MenuWidget>(newEntries, m_font, this);
         }
     }
 
@@ -348,111 +317,255 @@ private:
     int hoverIndex;
     std::vector<std::unique_ptr<MenuWidget>> m_submenus;
     MenuWidget* parent;
-    std::map<std::string, sf::Texture> iconCache;
+    bool m_dirty = true;
+
+    // 布局缓存：宽度、每项顶部偏移的前缀和（比项数多一项，末项为总高）、预生成的文本
+    float m_width = 0.f;
+    std::vector<float> m_itemTop;
+    std::vector<sf::Text> m_labels;
+
+    // 长列表模式：只含普通菜单项且超过 LIST_ROWS 项的子菜单（如皮肤列表）
+    // 顶部为筛选栏，只布局和绘制可见行，文本在首次可见时生成，图标随绘制按需进入图集
+    static constexpr size_t LIST_ROWS = 9;            // 可见行数（保证在菜单窗口内放得下）
+    static constexpr float LIST_WIDTH = 200.f;
+    static constexpr float SEARCH_BAR_HEIGHT = 32.f;
+    bool m_virtual = false;
+    std::vector<char> m_labelBuilt;
+    std::vector<const MenuSearchKey*> m_searchKeys;
+    std::vector<uint32_t> m_filtered;                  // 当前筛选结果（条目序号）
+    std::vector<std::vector<uint32_t>> m_filterHistory; // 每次追加输入前的结果，退格时直接恢复
+    std::string m_query;
+    std::vector<size_t> m_queryLengths;                // 每次追加输入前的查询长度
+    sf::Text m_queryText;
+    size_t m_scrollRow = 0;
+
+    [[nodiscard]] float contentHeight() const {
+        return m_virtual ? SEARCH_BAR_HEIGHT + LIST_ROWS * 32.f : m_itemTop.back();
+    }
 
-    [[nodiscard]] int getItemIndexAt(const sf::Vector2f& mouse) const {
-        float y = m_position.y;
-        bool isSubMenu = parent != nullptr;
-        float width;
-        if (isSubMenu) {
-            float maxTextWidth = 0.f;
-            for (const auto& entry : m_entries) {
-                if (entry.type == MenuEntryType::Separator) continue;
-                sf::Text text;
-                text.setFont(m_font);
-                text.setCharacterSize(16);
-                text.setString(sf::String::fromUtf8(entry.text.begin(), entry.text.end()));
-                float textWidth = text.getLocalBounds().width;
-                float iconWidth = entry.iconPath.empty() ? 0.f : (32.f);
-                float toggleCircle = (entry.type == MenuEntryType::Toggle || entry.type == MenuEntryType::ToggleTri) ? 20.f : 0.f;
-                float totalWidth = iconWidth + textWidth + toggleCircle + 16.f;
-                if (entry.type == MenuEntryType::SubMenu) totalWidth += 18.f;
-                if (totalWidth > maxTextWidth) maxTextWidth = totalWidth;
+    void buildLabel(size_t i) {
+        sf::Text& text = m_labels[i];
+        text.setFont(m_font);
+        text.setCharacterSize(16);
+        text.setFillColor(sf::Color::Black);
+        text.setString(sf::String::fromUtf8(m_entries[i].text.begin(), m_entries[i].text.end())); // 支持中文
+    }
+
+    // 单项的高亮、图标和文本
+    void drawItemBody(sf::RenderTarget& target, size_t i, float y) {
+        constexpr float itemHeight = 32.f, padding = 8.f, iconSize = 24.f;
+        const auto& entry = m_entries[i];
+        float width = m_width;
+        // 圆角高亮
+        if (static_cast<int>(i) == hoverIndex) {
+            float highlightRadius = 10.f;
+            RoundedRectangleShape hi({ width - 8, itemHeight - 2 }, highlightRadius, 8);
+            hi.setFillColor(sf::Color(191, 191, 191, 223));
+            hi.setPosition(m_position.x + 4, y + 1);
+            target.draw(hi);
+        }
+        // 图标（取自共享图集，已按绘制尺寸缩放）
+        if (!entry.iconPath.empty()) {
+            IconAtlas& atlas = iconAtlas();
+            sf::IntRect rect = atlas.lookup(entry.iconPath);
+            if (rect.width > 0) {
+                sf::Sprite iconSprite(atlas.texture(), rect);
+                iconSprite.setPosition(m_position.x + padding, y + (itemHeight - iconSize) / 2.f);
+                target.draw(iconSprite);
             }
-            width = maxTextWidth + 4.f;
-        } else {
-            width = 135.f;
         }
-
-        for (size_t i = 0; i < m_entries.size(); ++i) {
-            if (m_entries[i].type == MenuEntryType::Separator) {
-                y += 8.f;
-                continue;
+        // 中文文本（布局时已生成，这里只设置位置；长列表首次可见时生成）
+        if (entry.type != MenuEntryType::Separator) {
+            if (m_virtual && !m_labelBuilt[i]) {
+                buildLabel(i);
+                m_labelBuilt[i] = 1;
             }
-            sf::FloatRect rect(m_position.x, y, width, 32.f);
-            if (rect.contains(mouse))
-                return static_cast<int>(i);
-            y += 32.f;
+            sf::Text& text = m_labels[i];
+            text.setPosition(m_position.x + padding + (!entry.iconPath.empty() ? iconSize + 8.f : 0.f), y + (itemHeight - static_cast<float>(text.getCharacterSize())) / 2.f - 2.f);
+            target.draw(text);
         }
-        return -1;
     }
 
-    [[nodiscard]] sf::Vector2f getSubmenuPosition(size_t index) const {
-        float y = m_position.y;
-        // 子菜单宽度动态，主菜单固定
-        bool isSubMenu = parent != nullptr;
-        float width;
-        if (isSubMenu) {
-            float maxTextWidth = 0.f;
-            for (const auto& entry : m_entries) {
-                if (entry.type == MenuEntryType::Separator) continue;
-                sf::Text text;
-                text.setFont(m_font);
-                text.setCharacterSize(16);
-                text.setString(sf::String::fromUtf8(entry.text.begin(), entry.text.end()));
-                float textWidth = text.getLocalBounds().width;
-                float iconWidth = entry.iconPath.empty() ? 0.f : (32.f);
-                float toggleCircle = (entry.type == MenuEntryType::Toggle || entry.type == MenuEntryType::ToggleTri) ? 20.f : 0.f;
-                float totalWidth = iconWidth + textWidth + toggleCircle + 16.f;
-                if (entry.type == MenuEntryType::SubMenu) totalWidth += 18.f;
-                if (totalWidth > maxTextWidth) maxTextWidth = totalWidth;
-            }
-            width = maxTextWidth + 4.f;
-        } else {
-            width = 135.f;
+    // 长列表：筛选栏 + 可见行 + 滚动条
+    void drawList(sf::RenderTarget& target) {
+        constexpr float margin = 4.f, itemHeight = 32.f, padding = 8.f;
+        float top = m_position.y + margin;
+
+        RoundedRectangleShape bar({ m_width - 8, SEARCH_BAR_HEIGHT - 6 }, 8.f, 8);
+        bar.setFillColor(sf::Color(245, 245, 245, 255));
+        bar.setPosition(m_position.x + 4, top + 3);
+        target.draw(bar);
+        m_queryText.setPosition(m_position.x + padding + 4, top + (SEARCH_BAR_HEIGHT - 14.f) / 2.f - 2.f);
+        target.draw(m_queryText);
+
+        top += SEARCH_BAR_HEIGHT;
+        size_t end = std::min(m_filtered.size(), m_scrollRow + LIST_ROWS);
+        for (size_t row = m_scrollRow; row < end; ++row) {
+            drawItemBody(target, m_filtered[row], top + static_cast<float>(row - m_scrollRow) * itemHeight);
         }
 
-        for (size_t i = 0; i < index; ++i) {
-            if (m_entries[i].type == MenuEntryType::Separator)
-                y += 8.f;
-            else
-                y += 32.f;
+        if (m_filtered.size() > LIST_ROWS) {
+            float trackHeight = LIST_ROWS * itemHeight;
+            float thumbHeight = std::max(16.f, trackHeight * LIST_ROWS / static_cast<float>(m_filtered.size()));
+            float thumbTop = (trackHeight - thumbHeight) * static_cast<float>(m_scrollRow) / static_cast<float>(m_filtered.size() - LIST_ROWS);
+            sf::RectangleShape thumb({ 3.f, thumbHeight });
+            thumb.setFillColor(sf::Color(127, 127, 127, 159));
+            thumb.setPosition(m_position.x + m_width - 4.f, top + thumbTop);
+            target.draw(thumb);
+        }
+    }
+
+    void updateQueryText() {
+        std::string shown = m_query.empty() ? "输入筛选（支持拼音首字母）" : m_query;
+        m_queryText.setString(sf::String::fromUtf8(shown.begin(), shown.end()));
+        m_queryText.setFillColor(m_query.empty() ? sf::Color(159, 159, 159) : sf::Color::Black);
+    }
+
+    void scrollTo(long row) {
+        long maxRow = m_filtered.size() > LIST_ROWS ? static_cast<long>(m_filtered.size() - LIST_ROWS) : 0;
+        auto clamped = static_cast<size_t>(std::clamp(row, 0L, maxRow));
+        if (clamped != m_scrollRow) {
+            m_scrollRow = clamped;
+            m_dirty = true;
         }
-        return { m_position.x + width - 4.f, y };
-    }
-
-    sf::Texture& getIcon(const std::string& path) {
-        auto it = iconCache.find(path);
-        if (it != iconCache.end()) return it->second;
-        sf::Texture tex;
-        sf::Image img;
-
-        // 仅支持 Windows，直接用 _wfopen 方式
-        std::wstring wpath = sf::String::fromUtf8(path.begin(), path.end()).toWideString();
-        if (FILE* fp = _wfopen(wpath.c_str(), L"rb")) {
-            fseek(fp, 0, SEEK_END);
-            long size = ftell(fp);
-            fseek(fp, 0, SEEK_SET);
-            std::vector<char> buffer(size);
-            fread(buffer.data(), 1, size, fp);
-            fclose(fp);
-            if (img.loadFromMemory(buffer.data(), buffer.size())) {
-                tex.loadFromImage(img);
+    }
+
+    // 追加输入：只在当前结果中继续筛选
+    void appendQuery(const std::string& text) {
+        m_filterHistory.push_back(m_filtered);
+        m_queryLengths.push_back(m_query.size());
+        m_query += asciiLower(text);
+        std::erase_if(m_filtered, [&](uint32_t i) { return !menuSearchMatch(*m_searchKeys[i], m_query); });
+    }
+
+    // 退格：恢复上一次输入前的结果
+    void popQuery() {
+        if (m_filterHistory.empty()) return;
+        m_filtered = std::move(m_filterHistory.back());
+        m_filterHistory.pop_back();
+        m_query.resize(m_queryLengths.back());
+        m_queryLengths.pop_back();
+    }
+
+    // 长列表专有事件：滚轮滚动、键入筛选
+    bool handleListEvent(const sf::Event& event, const sf::RenderWindow& window) {
+        // 点在筛选栏或空行上：吞掉，避免收起整个菜单
+        if (event.type == sf::Event::MouseButtonPressed) {
+            sf::Vector2f mousePos = window.mapPixelToCoords({ event.mouseButton.x, event.mouseButton.y });
+            return getItemIndexAt(mousePos) < 0 && mousePos.x >= m_position.x && mousePos.x < m_position.x + m_width &&
+                mousePos.y >= m_position.y && mousePos.y < m_position.y + contentHeight();
+        }
+        if (event.type == sf::Event::MouseWheelScrolled) {
+            sf::Vector2f mousePos = window.mapPixelToCoords({ event.mouseWheelScroll.x, event.mouseWheelScroll.y });
+            if (!isPointInMenu(mousePos)) return false;
+            scrollTo(static_cast<long>(m_scrollRow) - static_cast<long>(std::lround(event.mouseWheelScroll.delta * 3.f)));
+            int prevHover = hoverIndex;
+            hoverIndex = getItemIndexAt(mousePos);
+            if (hoverIndex != prevHover) m_dirty = true;
+            return true;
+        }
+        if (event.type == sf::Event::TextEntered) {
+            sf::Uint32 ch = event.text.unicode;
+            if (ch == 8) {
+                if (m_filterHistory.empty()) return true;
+                popQuery();
+            } else if (ch == 27) {
+                if (m_filterHistory.empty()) return false;
+                m_filtered = std::move(m_filterHistory.front());
+                m_filterHistory.clear();
+                m_queryLengths.clear();
+                m_query.clear();
+            } else if (ch >= 32 && ch != 127) {
+                std::basic_string<sf::Uint8> utf8 = sf::String(ch).toUtf8();
+                appendQuery(std::string(utf8.begin(), utf8.end()));
             } else {
-                tex.create(24, 24);
-                img.create(24, 24, sf::Color::Red);
-                tex.update(img);
+                return false;
             }
-        } else {
-            tex.create(24, 24);
-            img.create(24, 24, sf::Color::Red);
-            tex.update(img);
+            updateQueryText();
+            m_scrollRow = 0;
+            hoverIndex = -1;
+            m_dirty = true;
+            return true;
+        }
+        return false;
+    }
+
+    // 布局计算（构造时执行一次，刷新子菜单会重新构造控件）
+    void layout() {
+        constexpr float itemHeight = 32.f, separatorHeight = 8.f, padding = 8.f;
+        bool isSubMenu = parent != nullptr;
+
+        m_virtual = isSubMenu && m_entries.size() > LIST_ROWS &&
+            std::all_of(m_entries.begin(), m_entries.end(), [](const MenuEntry& e) { return e.type == MenuEntryType::Action; });
+        if (m_virtual) {
+            layoutList();
+            return;
         }
-        iconCache[path] = tex;
-        return iconCache[path];
+
+        m_itemTop.assign(1, 0.f);
+        m_labels.assign(m_entries.size(), sf::Text());
+        float maxTextWidth = 0.f;
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            const auto& entry = m_entries[i];
+            bool isSeparator = entry.type == MenuEntryType::Separator;
+            m_itemTop.push_back(m_itemTop.back() + (isSeparator ? separatorHeight : itemHeight));
+            if (isSeparator) continue;
+
+            buildLabel(i);
+            const sf::Text& text = m_labels[i];
+
+            // 子菜单宽度动态，主菜单固定
+            if (!isSubMenu) continue;
+            float textWidth = text.getLocalBounds().width;
+            float iconWidth = entry.iconPath.empty() ? 0.f : (32.f);
+            float toggleCircle = (entry.type == MenuEntryType::Toggle || entry.type == MenuEntryType::ToggleTri) ? 20.f : 0.f;
+            float totalWidth = padding + iconWidth + textWidth + toggleCircle + padding;
+            if (entry.type == MenuEntryType::SubMenu) totalWidth += 18.f;
+            if (totalWidth > maxTextWidth) maxTextWidth = totalWidth;
+        }
+        m_width = isSubMenu ? maxTextWidth + 4.f : 135.f;
+    }
+
+    // 长列表布局：固定宽度和行高，只准备筛选索引，不生成文本
+    void layoutList() {
+        m_width = LIST_WIDTH;
+        m_itemTop.assign(m_entries.size() + 1, 0.f);
+        m_labels.assign(m_entries.size(), sf::Text());
+        m_labelBuilt.assign(m_entries.size(), 0);
+        m_searchKeys.clear();
+        m_filtered.clear();
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            m_searchKeys.push_back(&menuSearchKey(m_entries[i].text));
+            m_filtered.push_back(static_cast<uint32_t>(i));
+        }
+        m_queryText.setFont(m_font);
+        m_queryText.setCharacterSize(14);
+        updateQueryText();
+    }
+
+    // 命中测试：在前缀和上二分查找
+    [[nodiscard]] int getItemIndexAt(const sf::Vector2f& mouse) const {
+        if (mouse.x < m_position.x || mouse.x >= m_position.x + m_width) return -1;
+        float localY = mouse.y - m_position.y;
+        // 长列表：筛选栏之下按固定行高换算到筛选结果
+        if (m_virtual) {
+            localY -= SEARCH_BAR_HEIGHT;
+            if (localY < 0.f || localY >= LIST_ROWS * 32.f) return -1;
+            size_t row = m_scrollRow + static_cast<size_t>(localY / 32.f);
+            return row < m_filtered.size() ? static_cast<int>(m_filtered[row]) : -1;
+        }
+        if (localY < 0.f || localY >= m_itemTop.back()) return -1;
+        auto it = std::upper_bound(m_itemTop.begin(), m_itemTop.end(), localY);
+        auto i = static_cast<size_t>(it - m_itemTop.begin()) - 1;
+        if (m_entries[i].type == MenuEntryType::Separator) return -1;
+        return static_cast<int>(i);
     }
 
-    friend void setFirstTriToggleToZero(MenuWidget* root);
+    [[nodiscard]] sf::Vector2f getSubmenuPosition(size_t index) const {
+        return { m_position.x + m_width - 4.f, m_position.y + m_itemTop[index] };
+    }
+
+    friend void resetFirstTriToggle(MenuWidget* root);
 };
 
 // 让MenuWidgetWithHide在main前定义
@@ -465,12 +578,33 @@ struct MenuWidgetWithHide : MenuWidget {
     }
 };
 
+// 菜单窗口尺寸
+static constexpr int MENU_W = 365, MENU_H = 394;
+
+// 弹出请求（主线程写入，菜单线程取走）
+struct MenuPopupRequest {
+    POINT screenPos{};
+    std::string showCase;
+    std::vector<MenuEntry> skinEntries;
+    std::vector<MenuEntry> modelEntries;
+    std::chrono::steady_clock::time_point requestTime;
+};
+
 // 内部全局变量（只在本文件使用）
 namespace {
     HWND menuHwnd = nullptr;
     MenuWidgetWithHide* menu = nullptr;
     std::thread menuThread;
     std::mutex menuThreadMutex;
+
+    // 请求锁：菜单线程启动后控件树只由它访问，主线程的修改（弹出、三态复位）以请求的形式交给它
+    std::mutex menuStateMutex;
+    std::optional<MenuPopupRequest> pendingPopup;
+    MenuWidget* pendingTriReset = nullptr;
+    bool menuThreadExit = false;
+
+    // 唤醒菜单线程（弹出、三态复位或退出），线程在窗口消息和该信号上等待
+    HANDLE menuWakeSignal = nullptr;
 }
 
 // 初始化菜单控件和窗口（只初始化一次，后续复用）
@@ -489,17 +623,18 @@ void safeCloseMenuWindow() {
     if (menu) menu->hide();
 }
 
-// 修改为立即销毁菜单窗口和线程
+// 退出时关闭常驻菜单窗口和线程
 void forceCloseMenuWindow() {
     static std::mutex closeMutex;
     std::lock_guard lock(closeMutex);
-    // 直接关闭菜单窗口（如果存在）
-    if (menuHwnd) {
-        // 强制关闭窗口
-        PostMessage(menuHwnd, WM_CLOSE, 0, 0);
-        menuHwnd = nullptr;
+    {
+        std::lock_guard stateLock(menuStateMutex);
+        menuThreadExit = true;
+        pendingPopup.reset();
     }
-    if (menu) menu->hide();
+    // 唤醒阻塞在窗口消息上的菜单线程
+    if (menuWakeSignal) SetEvent(menuWakeSignal);
+    if (menuHwnd) PostMessage(menuHwnd, WM_CLOSE, 0, 0);
 }
 
 // 等待菜单线程安全退出
@@ -510,27 +645,142 @@ void waitMenuThreadExit() {
     }
 }
 
-// 绘制菜单并处理事件（窗口和RenderTexture全部局部）
-void drawMenu(MenuWidget* menuPtr, sf::RenderWindow* parentWindow, const sf::Vector2f& popupPos) {
+// 绘制菜单到RenderTexture
+void drawMenu(MenuWidget* menuPtr, sf::RenderTexture& target) {
+    target.clear(sf::Color::Transparent);
+    menuPtr->draw(target);
+    target.display();
+}
+
+// 常驻菜单线程：窗口和渲染目标只创建一次，弹出时只移动、显示、重绘
+// 显示期间只在菜单状态变化时重绘和更新分层窗口，其余时间阻塞等待窗口消息
+static void menuThreadFunc() {
     sf::RenderWindow menuWindow;
     sf::RenderTexture menuTexture;
 
-    int menuW = 365, menuH = 394;
-
-    menuTexture.create(menuW, menuH);
-    menuWindow.create(sf::VideoMode(menuW, menuH), L"Menu", sf::Style::None);
-    menuWindow.setFramerateLimit(30);
+    menuTexture.create(MENU_W, MENU_H);
+    menuWindow.create(sf::VideoMode(MENU_W, MENU_H), L"Menu", sf::Style::None);
     menuHwnd = menuWindow.getSystemHandle();
     LONG exStyle = GetWindowLong(menuHwnd, GWL_EXSTYLE);
     exStyle |= WS_EX_TOPMOST | WS_EX_TOOLWINDOW | WS_EX_LAYERED;
     SetWindowLong(menuHwnd, GWL_EXSTYLE, exStyle);
+    ShowWindow(menuHwnd, SW_HIDE);
+
+    auto present = [&] {
+        drawMenu(menu, menuTexture);
+        setClickThrough(menuHwnd, menuTexture.getTexture().copyToImage());
+        menuWindow.clear(sf::Color::Transparent);
+        sf::Sprite spr(menuTexture.getTexture());
+        menuWindow.draw(spr);
+        menuWindow.display();
+    };
+
+    while (true) {
+        // 隐藏状态下等待弹出请求；窗口仍然存在，必须照常处理消息，
+        // 否则其他程序广播的 SendMessage（WM_SETTINGCHANGE 等）会卡在本线程
+        MenuPopupRequest request;
+        MenuWidget* triReset = nullptr;
+        bool hasPopup = false;
+        bool exitThread = false;
+        while (true) {
+            sf::Event menuEvent{};
+            while (menuWindow.pollEvent(menuEvent)) {} // 隐藏期间的事件直接丢弃
+            {
+                std::lock_guard lk(menuStateMutex);
+                if (menuThreadExit) { exitThread = true; break; }
+                triReset = std::exchange(pendingTriReset, nullptr);
+                if (pendingPopup) {
+                    request = std::move(*pendingPopup);
+                    pendingPopup.reset();
+                    hasPopup = true;
+                }
+            }
+            if (triReset) resetFirstTriToggle(triReset);
+            if (hasPopup) break;
+            MsgWaitForMultipleObjectsEx(1, &menuWakeSignal, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        }
+        if (exitThread) break;
+
+        // 动态刷新两个子菜单内容
+        for (size_t i = 0; i < menu->entries().size(); ++i) {
+            if (menu->entries()[i].text == "切换皮肤" && menu->entries()[i].type == MenuEntryType::SubMenu) {
+                menu->refreshSubmenu(i, request.skinEntries);
+            }
+            if (menu->entries()[i].text == "切换模型" && menu->entries()[i].type == MenuEntryType::SubMenu) {
+                menu->refreshSubmenu(i, request.modelEntries);
+            }
+        }
+
+        // 先画好首帧再显示，避免闪出上一次的内容
+        menu->show({ 6, 6 });
+        SetWindowPos(menuHwnd, HWND_TOPMOST, request.screenPos.x, request.screenPos.y, MENU_W, MENU_H, SWP_NOACTIVATE);
+        menu->takeDirty();
+        present();
+        SetWindowPos(menuHwnd, HWND_TOPMOST, request.screenPos.x, request.screenPos.y, MENU_W, MENU_H, SWP_SHOWWINDOW);
+        SetForegroundWindow(menuHwnd);
+
+        auto latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - request.requestTime);
+        printf(CONSOLE_BRIGHT_GREEN "[MENU] %s (%.1f ms)" CONSOLE_RESET "\n", request.showCase.c_str(), latency.count());
+
+        while (true) {
+            MenuWidget* triReset = nullptr;
+            {
+                std::lock_guard lk(menuStateMutex);
+                if (menuThreadExit) { exitThread = true; break; }
+                // 显示期间又来了新的弹出请求：回到外层重新定位
+                if (pendingPopup) break;
+                triReset = std::exchange(pendingTriReset, nullptr);
+            }
+            if (triReset) resetFirstTriToggle(triReset);
+
+            sf::Event menuEvent{};
+            bool closed = false;
+            while (menuWindow.pollEvent(menuEvent)) {
+                if (menuEvent.type == sf::Event::Closed) {
+                    // 只有退出时才结束线程，Alt+F4 等关闭请求当作收起菜单，否则之后右键不再弹出
+                    std::lock_guard lk(menuStateMutex);
+                    if (menuThreadExit) exitThread = true;
+                    else closed = true;
+                    break;
+                }
+                menu->handleEvent(menuEvent, menuWindow);
+            }
+            if (exitThread) break;
+            if (closed) menu->hide();
+
+            // 失去焦点或菜单已收起则隐藏窗口，等待下次弹出
+            if (!menu->isVisible() || GetForegroundWindow() != menuHwnd) {
+                menu->hide();
+                ShowWindow(menuHwnd, SW_HIDE);
+                break;
+            }
+
+            if (menu->takeDirty()) present();
+
+            // 无变化时阻塞到下一条窗口消息或唤醒信号
+            MsgWaitForMultipleObjectsEx(1, &menuWakeSignal, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        }
+        if (exitThread) break;
+    }
+
+    if (menu) menu->hide();
+    menuHwnd = nullptr;
+    menuWindow.close();
+}
+
+// 弹出菜单接口
+void popupMenu(sf::RenderWindow* parentWindow, const sf::Vector2f& pos, MenuWidgetWithHide* menuPtr) {
+    std::lock_guard lock(menuThreadMutex);
+
+    if (!menuPtr) return;
+    auto requestTime = std::chrono::steady_clock::now();
 
     // 获取工作区
     RECT workArea;
     SystemParametersInfo(SPI_GETWORKAREA, 0, &workArea, 0);
 
     // popupPos为窗口坐标，需转换为屏幕坐标
-    POINT desktopPos = { static_cast<LONG>(popupPos.x), static_cast<LONG>(popupPos.y) };
+    POINT desktopPos = { static_cast<LONG>(pos.x), static_cast<LONG>(pos.y) };
     ClientToScreen(parentWindow->getSystemHandle(), &desktopPos);
 
     // 计算四个方位的可用性
@@ -538,103 +788,65 @@ void drawMenu(MenuWidget* menuPtr, sf::RenderWindow* parentWindow, const sf::Vec
     POINT pt = { 0, 0 };
 
     // 右上
-    if (desktopPos.x + menuW <= workArea.right && desktopPos.y - menuH >= workArea.top) {
+    if (desktopPos.x + MENU_W <= workArea.right && desktopPos.y - MENU_H >= workArea.top) {
         showCase = "right-upon";
         pt.x = desktopPos.x;
-        pt.y = desktopPos.y - menuH;
+        pt.y = desktopPos.y - MENU_H;
     }
     // 右下
-    else if (desktopPos.x + menuW <= workArea.right && desktopPos.y + menuH <= workArea.bottom) {
+    else if (desktopPos.x + MENU_W <= workArea.right && desktopPos.y + MENU_H <= workArea.bottom) {
         showCase = "right-down";
         pt.x = desktopPos.x;
         pt.y = desktopPos.y;
     }
     // 左上
-    else if (desktopPos.x - menuW >= workArea.left && desktopPos.y - menuH >= workArea.top) {
+    else if (desktopPos.x - MENU_W >= workArea.left && desktopPos.y - MENU_H >= workArea.top) {
         showCase = "left-upon";
         pt.x = desktopPos.x - 145;
-        pt.y = desktopPos.y - menuH;
+        pt.y = desktopPos.y - MENU_H;
     }
     // 左下
-    else if (desktopPos.x - menuW >= workArea.left && desktopPos.y + menuH <= workArea.bottom) {
+    else if (desktopPos.x - MENU_W >= workArea.left && desktopPos.y + MENU_H <= workArea.bottom) {
         showCase = "left-down";
         pt.x = desktopPos.x - 145;
         pt.y = desktopPos.y;
     }
 
-    // 直接用桌面坐标
-    SetWindowPos(menuHwnd, HWND_TOPMOST, pt.x, pt.y, menuW, menuH, SWP_SHOWWINDOW);
-    menuPtr->show({ 6, 6 });
-    printf(CONSOLE_BRIGHT_GREEN "[MENU] %s" CONSOLE_RESET "\n", showCase.c_str());
-
-    while (menuWindow.isOpen()) {
-        sf::Event menuEvent{};
-        while (menuWindow.pollEvent(menuEvent)) {
-            if (menuEvent.type == sf::Event::Closed) {
-                safeCloseMenuWindow();
-                menuWindow.close();
-                return;
-            }
-            menuPtr->handleEvent(menuEvent, menuWindow);
-        }
-
-        menuTexture.clear(sf::Color::Transparent);
-        menuPtr->draw(menuTexture);
-        menuTexture.display();
-
-        sf::Image img = menuTexture.getTexture().copyToImage();
-        setClickThrough(menuHwnd, img);
-
-        menuWindow.clear(sf::Color::Transparent);
-        sf::Sprite spr(menuTexture.getTexture());
-        menuWindow.draw(spr);
-        menuWindow.display();
-
-        if (GetForegroundWindow() != menuHwnd) {
-            safeCloseMenuWindow();
-            menuWindow.close();
-            return;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(0));
-    }
-}
-
-// 弹出菜单接口
-void popupMenu(sf::RenderWindow* parentWindow, const sf::Vector2f& pos, MenuWidgetWithHide* menuPtr) {
-    std::lock_guard lock(menuThreadMutex);
-
-    if (!menuPtr) return;
-
-    // 动态刷新两个子菜单内容
+    // 子菜单内容在主线程生成（读取模型库），交给菜单线程替换
     extern SkinCallback g_skinCallback;
     extern ModelCallback g_modelCallback;
-    auto skinEntries = getCurrentSkinEntries(g_skinCallback);
-    auto modelEntries = getCurrentModelEntries(g_modelCallback);
-
-    for (size_t i = 0; i < menuPtr->entries().size(); ++i) {
-        if (menuPtr->entries()[i].text == "切换皮肤" && menuPtr->entries()[i].type == MenuEntryType::SubMenu) {
-            menuPtr->refreshSubmenu(i, skinEntries);
-        }
-        if (menuPtr->entries()[i].text == "切换模型" && menuPtr->entries()[i].type == MenuEntryType::SubMenu) {
-            menuPtr->refreshSubmenu(i, modelEntries);
-        }
+    {
+        std::lock_guard stateLock(menuStateMutex);
+        pendingPopup = MenuPopupRequest{ pt, showCase, getCurrentSkinEntries(g_skinCallback),
+            getCurrentModelEntries(g_modelCallback), requestTime };
+        menuThreadExit = false;
     }
 
-    // 等待上一个菜单线程完全退出
-    if (menuThread.joinable()) {
-        safeCloseMenuWindow();
-        menuThread.join();
+    // 首次弹出时启动常驻菜单线程
+    if (!menuWakeSignal) menuWakeSignal = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!menuThread.joinable()) {
+        menuThread = std::thread(menuThreadFunc);
     }
-    // 启动新线程弹出菜单
-    menuThread = std::thread([=]() {
-        drawMenu(menu, parentWindow, pos);
-    });
-    // 不detach，始终join保证线程安全
+    SetEvent(menuWakeSignal);
 }
 
-// 设置第一个三态按钮为0（只设置第一个找到的ToggleTri）
+// 设置第一个三态按钮为0：菜单线程已启动时交给它执行，否则控件树只有主线程在用，直接修改
 void setFirstTriToggleToZero(MenuWidget* root) {
     if (!root) return;
+    std::lock_guard lock(menuThreadMutex);
+    if (!menuThread.joinable()) {
+        resetFirstTriToggle(root);
+        return;
+    }
+    {
+        std::lock_guard stateLock(menuStateMutex);
+        pendingTriReset = root;
+    }
+    if (menuWakeSignal) SetEvent(menuWakeSignal);
+}
+
+// 只设置第一个找到的ToggleTri（菜单线程或菜单线程启动前调用）
+static void resetFirstTriToggle(MenuWidget* root) {
     std::vector<MenuWidget*> stack;
     stack.push_back(root);
     while (!stack.empty()) {
@@ -647,6 +859,7 @@ void setFirstTriToggleToZero(MenuWidget* root) {
             if (entry.type == MenuEntryType::ToggleTri) {
                 if (entry.toggleState != 0) {
                     entry.toggleState = 0;
+                    widget->m_dirty = true;
                     if (entry.toggleCallback) entry.toggleCallback(0);
                 }
                 return;
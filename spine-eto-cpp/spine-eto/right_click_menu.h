@@ -87,13 +87,13 @@ struct MenuWidgetWithHide;
 // 初始化菜单控件
 MenuWidgetWithHide* initMenu(const MenuModel& model, const sf::Font& font, std::function<void()> onHideAll);
 
-// 弹出菜单（每次弹出直接创建新窗口，主线程不阻塞，无需线程管理）
+// 弹出菜单（复用常驻菜单窗口，只重新定位、显示和重绘，主线程不阻塞）
 void popupMenu(sf::RenderWindow* parentWindow, const sf::Vector2f& pos, MenuWidgetWithHide* menu);
 
 // 绘制菜单到RenderTexture
 void drawMenu(MenuWidget* menu, sf::RenderTexture& target);
 
-// 设置第一个三态按钮为0（只设置第一个找到的ToggleTri）
+// 设置第一个三态按钮为0（只设置第一个找到的ToggleTri），菜单线程运行时转交给它执行
 void setFirstTriToggleToZero(MenuWidget* root);
 
 // 主动强制关闭所有菜单线程和窗口
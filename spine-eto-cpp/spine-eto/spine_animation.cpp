@@ -6,11 +6,12 @@
 #include <spine/SkeletonBinary.h>
 #include <spine/SkeletonJson.h>
 
-#include <filesystem>
-#include <fstream>
 #include <iostream>
+#include <vector>
 
+#include "asset_store.h"
 #include "console_colors.h"
+#include "content_hash.h"
 #include "queue_utils.h"
 #include "spine_animation.h"
 #include "window_physics.h"
@@ -33,88 +34,69 @@ SpineLoadInfo SpineAnimation::loadFromJson(const std::string& atlasFile, const s
 
 // --- 统一加载实现 ---
 SpineLoadInfo SpineAnimation::loadImpl(const std::string& atlasPath, const std::string& skeletonPath, bool isJson) {
-    // --------- 新增：复制到临时目录，解决中文路径问题 ---------
-    namespace fs = std::filesystem;
-    fs::create_directories("./models/temp");
-
-    // 复制 atlas
-    fs::path atlasSrc(atlasPath);
-    fs::path atlasDst = fs::path("./models/temp") / atlasSrc.filename();
-    try { copy_file(atlasSrc, atlasDst, fs::copy_options::overwrite_existing); } catch (...) {}
-
-    // 复制 skel/json
-    fs::path skelSrc(skeletonPath);
-    fs::path skelDst = fs::path("./models/temp") / skelSrc.filename();
-    try { copy_file(skelSrc, skelDst, fs::copy_options::overwrite_existing); } catch (...) {}
-
-    // 复制 png（和atlas同目录同名但扩展名为png）
-    fs::path pngSrc = atlasSrc.parent_path() / (atlasSrc.stem().string() + ".png");
-    fs::path pngDst = fs::path("./models/temp") / pngSrc.filename();
-    if (exists(pngSrc)) {
-        try { copy_file(pngSrc, pngDst, fs::copy_options::overwrite_existing); } catch (...) {}
-    }
-
-    // 用临时路径加载
-    std::string tempAtlas = atlasDst.string();
-    std::string tempSkel = skelDst.string();
-
     SpineLoadInfo info;
-    info.atlas = std::make_shared<Atlas>(tempAtlas.c_str(), new SFMLTextureLoader());
-    if (info.atlas->getPages().size() == 0) {
-        std::cout << CONSOLE_BRIGHT_RED << "Atlas load error: " << tempAtlas << CONSOLE_RESET << std::endl;
-        info.atlas.reset();
-        return info;
-    }
-    std::cout << CONSOLE_BRIGHT_GREEN << "Atlas load down!" << CONSOLE_RESET << std::endl;
 
-    // 检查骨架文件类型
-    std::ifstream file(tempSkel, std::ios::binary);
-    if (!file) {
-        std::cout << "Failed to open skeleton file: " << tempSkel << std::endl;
-        info.atlas.reset();
+    // 路径为 UTF-8，整体读入内存后从内存解析，中文路径不再需要复制到临时目录
+    std::vector<char> atlasData, skelData;
+    if (!readWholeFile(utf8ToPath(atlasPath), atlasData)) {
+        std::cout << CONSOLE_BRIGHT_RED << "Atlas load error: " << atlasPath << CONSOLE_RESET << std::endl;
         return info;
     }
-    std::vector<char> header(10);
-    file.read(header.data(), 10);
-    if (file.gcount() < 10) {
-        std::cout << "Skeleton file is too short: " << tempSkel << std::endl;
-        file.close();
-        info.atlas.reset();
+    if (!readWholeFile(utf8ToPath(skeletonPath), skelData)) {
+        std::cout << "Failed to open skeleton file: " << skeletonPath << std::endl;
         return info;
     }
-    // 检查是否是JSON文件
-    bool fileIsJson = false;
-    if (file.gcount() >= 10) {
-        std::string jsonSignature(header.data() + 2, 8); // 第3到10个字节
-        if (jsonSignature == "skeleton") {
-            fileIsJson = true;
-        }
+    if (skelData.size() < 10) {
+        std::cout << "Skeleton file is too short: " << skeletonPath << std::endl;
+        return info;
     }
-    file.close();
 
-    // 优先以参数isJson为准，否则用文件头判断
-    bool useJson = isJson || fileIsJson;
+    // 贴图页按 atlas 所在目录解析，目录也计入键
+    size_t slash = atlasPath.find_last_of("/\\");
+    std::string atlasDir = slash == std::string::npos ? std::string() : atlasPath.substr(0, slash);
+    uint64_t key = contentHash(skelData.data(), skelData.size(),
+        contentHash(atlasData.data(), atlasData.size(), contentHash(atlasDir.data(), atlasDir.size())));
 
-    if (useJson) {
-        SkeletonJson json(info.atlas.get());
-        json.setScale(1.0f);
-        info.skeletonData.reset(json.readSkeletonDataFile(tempSkel.c_str()));
-        if (!info.skeletonData) {
-            std::cout << CONSOLE_BRIGHT_RED << "JSON load error: " << json.getError().buffer() << CONSOLE_RESET << std::endl;
-            info.atlas.reset();
-            return info;
-        }
+    if (findCachedSkeleton(key, info.atlas, info.skeletonData)) {
+        std::cout << CONSOLE_BRIGHT_GREEN << "Skeleton reused: " << hashToHex(key) << CONSOLE_RESET << std::endl;
     } else {
-        SkeletonBinary binary(info.atlas.get());
-        binary.setScale(1.0f);
-        info.skeletonData.reset(binary.readSkeletonDataFile(tempSkel.c_str()));
-        if (!info.skeletonData) {
-            std::cout << CONSOLE_BRIGHT_RED << "Binary load error: " << binary.getError().buffer() << CONSOLE_RESET << std::endl;
+        info.atlas = std::make_shared<Atlas>(atlasData.data(), static_cast<int>(atlasData.size()), atlasDir.c_str(),
+            sharedTextureLoader());
+        if (info.atlas->getPages().size() == 0) {
+            std::cout << CONSOLE_BRIGHT_RED << "Atlas load error: " << atlasPath << CONSOLE_RESET << std::endl;
             info.atlas.reset();
             return info;
         }
+        std::cout << CONSOLE_BRIGHT_GREEN << "Atlas load down!" << CONSOLE_RESET << std::endl;
+
+        // 检查是否是JSON文件（第3到10个字节）；优先以参数isJson为准
+        bool fileIsJson = std::string(skelData.data() + 2, 8) == "skeleton";
+        bool useJson = isJson || fileIsJson;
+
+        if (useJson) {
+            skelData.push_back('\0');
+            SkeletonJson json(info.atlas.get());
+            json.setScale(1.0f);
+            info.skeletonData.reset(json.readSkeletonData(skelData.data()));
+            if (!info.skeletonData) {
+                std::cout << CONSOLE_BRIGHT_RED << "JSON load error: " << json.getError().buffer() << CONSOLE_RESET << std::endl;
+                info.atlas.reset();
+                return info;
+            }
+        } else {
+            SkeletonBinary binary(info.atlas.get());
+            binary.setScale(1.0f);
+            info.skeletonData.reset(binary.readSkeletonData(reinterpret_cast<const unsigned char*>(skelData.data()),
+                static_cast<int>(skelData.size())));
+            if (!info.skeletonData) {
+                std::cout << CONSOLE_BRIGHT_RED << "Binary load error: " << binary.getError().buffer() << CONSOLE_RESET << std::endl;
+                info.atlas.reset();
+                return info;
+            }
+        }
+        std::cout << CONSOLE_BRIGHT_GREEN << "Skeleton load down!" << CONSOLE_RESET << std::endl;
+        cacheSkeleton(key, info.atlas, info.skeletonData);
     }
-    std::cout << CONSOLE_BRIGHT_GREEN << "Skeleton load down!" << CONSOLE_RESET << std::endl;
 
     auto& anims = info.skeletonData->getAnimations();
     for (size_t i = 0; i < anims.size(); ++i) {
@@ -216,6 +198,10 @@ std::string SpineAnimation::getCurrentAnimation() const {
     return "";
 }
 
+bool SpineAnimation::hasAnimation(const std::string& anim) const {
+    return skeletonData && skeletonData->findAnimation(anim.c_str()) != nullptr;
+}
+
 // --- 临时播放动画 ---
 void SpineAnimation::playTemp(const std::string& name, bool loop, float mixDuration) {
     if (drawable) {
@@ -262,6 +248,8 @@ void SpineAnimation::staticSpineEventCallback(AnimationState* state, EventType t
     switch (type) {
         case EventType_Start:
             std::cout << CONSOLE_BRIGHT_BLACK << "[START] Animation: " << animationName << CONSOLE_RESET << std::endl;
+            // Move动画开始时唤醒休眠中的物理
+            if (animationName == "Move") wakeWindowPhysics();
             break;
         case EventType_Complete:
             std::cout << CONSOLE_BRIGHT_BLACK << "[COMPLETE] Animation: " << animationName << CONSOLE_RESET << std::endl;
@@ -54,6 +54,8 @@ public:
 
     [[nodiscard]] std::vector<std::string> getQueue() const;
     [[nodiscard]] std::string getCurrentAnimation() const;
+    // 当前模型是否包含该动画（外部传入的名称须先检查）
+    [[nodiscard]] bool hasAnimation(const std::string& anim) const;
 
     // 临时播放动画（可循环/单次），立即打断队列
     void playTemp(const std::string& anim, bool loop = false, float mixDuration = -1.0f);
@@ -5,18 +5,15 @@
 #include <windows.h>
 
 #include "console_colors.h"
+#include "model_database.h"
 #include "right_click_menu.h"
 #include "spine_animation.h"
 #include "spine_win_utils.h"
 #include "queue_utils.h"
 #include "window_physics.h"
 
-#include "json.hpp"
-
 using namespace spine;
 
-extern nlohmann::json g_modelDatabase;
-
 // 声明全局辉光信号变量
 extern bool g_showGlowEffect;
 // 声明全局交互半透明信号变量
@@ -171,6 +168,23 @@ void handleWindowCursor(HWND hwnd, bool isPressed) {
     }
 }
 
+// 工作区变化标记（任务栏移动、分辨率切换时由窗口过程置位，主循环消费）
+static bool g_workAreaChanged = false;
+static WNDPROC g_prevWndProc = nullptr;
+
+static LRESULT CALLBACK petWindowProc(HWND h, UINT msg, WPARAM wParam, LPARAM lParam) {
+    if ((msg == WM_SETTINGCHANGE && wParam == SPI_SETWORKAREA) || msg == WM_DISPLAYCHANGE) {
+        g_workAreaChanged = true;
+    }
+    return CallWindowProc(g_prevWndProc, h, msg, wParam, lParam);
+}
+
+bool consumeWorkAreaChanged() {
+    bool changed = g_workAreaChanged;
+    g_workAreaChanged = false;
+    return changed;
+}
+
 // 显示主窗口
 void showMainWindow() {
     ShowWindow(hwnd, SW_SHOW);
@@ -206,6 +220,9 @@ void initWindowAndShader(int width, int height, int offset) {
 
     SetWindowPos(hwnd, HWND_TOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE);
 
+    // 挂接窗口过程，监听工作区变化
+    g_prevWndProc = reinterpret_cast<WNDPROC>(SetWindowLongPtr(hwnd, GWLP_WNDPROC, reinterpret_cast<LONG_PTR>(petWindowProc)));
+
     renderTexture.create(width, height);
 
     // 获取屏幕工作区（排除任务栏），并打印
@@ -267,32 +284,17 @@ void initSpineModel(int width, int height, int yOffset, int activeLevel, float m
     // 新建 SpineAnimation
     animSystem = new SpineAnimation(width, height);
 
-    // 动态获取当前皮肤和模型的路径
-    extern nlohmann::json g_modelDatabase;
-    std::string atlasPath, skelPath;
-    do {
-        if (!g_modelDatabase.contains("default") || !g_modelDatabase.contains("library")) break;
-        const auto& def = g_modelDatabase["default"];
-        if (!def.is_array() || def.size() < 2) break;
-        const auto& lib = g_modelDatabase["library"];
-        if (!lib.contains(def[0])) break;
-        const auto& skinObj = lib[def[0]];
-        if (!skinObj.contains(def[1])) break;
-        const auto& modelObj = skinObj[def[1]];
-        if (!modelObj.contains("atlas") || !modelObj.contains("skel")) break;
-        atlasPath = modelObj["atlas"].get<std::string>();
-        skelPath = modelObj["skel"].get<std::string>();
-    } while (false);
-
-    if (atlasPath.empty() || skelPath.empty()) {
+    // 当前皮肤和模型的路径（加载模型库时已缓存）
+    const ModelRecord* current = g_modelDatabase.currentModel();
+    if (!current || current->atlas.empty() || current->skel.empty()) {
         std::cout << CONSOLE_BRIGHT_RED << "模型路径未找到，请检查 package.json" << CONSOLE_RESET << std::endl;
         return;
     }
 
     // 加载资源
     auto info = SpineAnimation::loadFromBinary(
-        atlasPath,
-        skelPath
+        current->atlas,
+        current->skel
     );
 
     // 获取运动方向决定朝向
@@ -350,6 +352,20 @@ void reinitSpineModel() {
     initSpineModel(g_lastWidth, g_lastHeight, g_lastYOffset, g_lastActiveLevel, g_lastMixTime, g_lastScale);
 }
 
+void updateSpineSettings(int activeLevel, float mixTime) {
+    if (!g_hasRecord) return;
+    if (activeLevel != g_lastActiveLevel) {
+        g_lastActiveLevel = activeLevel;
+        g_lastMixTime = mixTime;
+        reinitSpineModel();
+        return;
+    }
+    if (mixTime != g_lastMixTime) {
+        g_lastMixTime = mixTime;
+        if (animSystem) animSystem->setGlobalMixTime(mixTime);
+    }
+}
+
 // 更高效的辉光实现：只遍历一次像素，利用距离变换思想
 sf::Image addGlowToAlphaEdge(const sf::Image& src, sf::Color glowColor, int glowWidth) {
     sf::Vector2u size = src.getSize();
@@ -22,5 +22,10 @@ void setClickThrough(HWND hwnd, const sf::Image& image);
 sf::Image addGlowToAlphaEdge(const sf::Image& src, sf::Color glowColor, int glowWidth = 4);
 
 void initWindowAndShader(int width, int height, int offset);
+
+// 工作区是否发生变化（读取后清除标记）
+bool consumeWorkAreaChanged();
 void initSpineModel(int width, int height, int yOffset, int activeLevel, float mixTime, float Scale);
 void reinitSpineModel();
+// 配置热加载：活跃度变化时重新加载模型，只有过渡时间变化时直接应用
+void updateSpineSettings(int activeLevel, float mixTime);
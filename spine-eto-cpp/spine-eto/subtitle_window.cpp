@@ -1,51 +1,85 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <cmath>
-#include <condition_variable>
 #include <deque>
-#include <map>
 #include <mutex>
-#include <set>
 #include <string>
 #include <thread>
 #include <windows.h>
 
+#include "key_binding.h"
+#include "key_event_ring.h"
+#include "key_stats.h"
 #include "keyboard_hook_tool.h"
 #include "spine_win_utils.h"
+#include "vk_code_2_string.h"
 
-// 全局变量
-std::set<DWORD> g_pressedKeys;
-std::mutex g_keyMutex;
+// 弹幕窗口是否可见（字幕线程据此创建或销毁窗口）
+static std::atomic g_windowVisible{true};
+
+// 钩子线程 → 字幕线程的键盘事件队列，钩子回调内不加锁、不阻塞
+static SpscRing<KeyEvent, 1024> g_keyEvents;
+
+// 有新事件时唤醒空闲的字幕线程（自动复位事件）
+static HANDLE g_keyEventSignal = nullptr;
+
+static void signalSubtitleThread() {
+    if (g_keyEventSignal) SetEvent(g_keyEventSignal);
+}
 
-// Caps/NumLock/ScrollLock状态
+// 当前按下的键（仅字幕线程访问）
+KeyState g_pressedKeys;
+
+// 键盘统计（仅字幕线程写入，定期落盘）
+static KeyStats g_keyStats;
+static const std::string KEY_STATS_PATH = "./key_stats.bin";
+
+// Caps/NumLock/ScrollLock状态（仅字幕线程访问）
 bool g_capsOn = false;
 bool g_numOn = false;
 bool g_scrollOn = false;
-std::mutex g_lockStateMutex;
+
+// 读取锁定键状态（钩子回调中按键尚未生效，需传 false 取反）
+static uint8_t queryLockBits(bool b) {
+    uint8_t bits = 0;
+    if ((GetKeyState(VK_CAPITAL) & 1) == 0 ^ b) bits |= KEY_LOCK_CAPS;
+    if ((GetKeyState(VK_NUMLOCK) & 1) == 0 ^ b) bits |= KEY_LOCK_NUM;
+    if ((GetKeyState(VK_SCROLL) & 1) == 0 ^ b) bits |= KEY_LOCK_SCROLL;
+    return bits;
+}
+
+static void applyLockBits(uint8_t bits) {
+    g_capsOn = bits & KEY_LOCK_CAPS;
+    g_numOn = bits & KEY_LOCK_NUM;
+    g_scrollOn = bits & KEY_LOCK_SCROLL;
+}
 
 // 获取锁定键状态
 void updateLockStates(bool b = true) {
-    std::lock_guard lock(g_lockStateMutex);
-    g_capsOn = (GetKeyState(VK_CAPITAL) & 1) == 0 ^ b;
-    g_numOn = (GetKeyState(VK_NUMLOCK) & 1) == 0 ^ b;
-    g_scrollOn = (GetKeyState(VK_SCROLL) & 1) == 0 ^ b;
+    applyLockBits(queryLockBits(b));
 }
 
-// 钩子回调
+// 钩子回调：只投递事件，状态由字幕线程按顺序重放（窗口隐藏时也投递，统计和按键绑定不依赖字幕窗口）
 LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
     if (nCode == HC_ACTION) {
         auto* p = static_cast<KBDLLHOOKSTRUCT*>(reinterpret_cast<void*>(lParam));
-        std::lock_guard lock(g_keyMutex);
+        KeyEvent ev;
+        ev.vkCode = p->vkCode;
+        ev.time = p->time;
         if (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN) {
-            g_pressedKeys.insert(p->vkCode);
+            ev.down = true;
             // 检查锁定键
             if (p->vkCode == VK_CAPITAL || p->vkCode == VK_NUMLOCK || p->vkCode == VK_SCROLL) {
-                updateLockStates(false);
+                ev.lockBits = queryLockBits(false);
             }
+            g_keyEvents.push(ev);
+            signalSubtitleThread();
         } else if (wParam == WM_KEYUP || wParam == WM_SYSKEYUP) {
-            g_pressedKeys.erase(p->vkCode);
+            g_keyEvents.push(ev);
+            signalSubtitleThread();
         }
     }
     return CallNextHookEx(nullptr, nCode, wParam, lParam);
@@ -86,9 +120,6 @@ HWND getSubtitleHwnd() {
 
 static std::thread g_subtitleThread;
 static std::atomic g_threadExit{false};
-static std::atomic g_windowVisible{true};
-static std::mutex g_windowMutex;
-static std::condition_variable g_windowCv;
 
 // 参数缓存
 static float g_subtitleDuration = 2.5f;
@@ -97,7 +128,7 @@ static int g_modeWidth = 450;
 
 void showSubtitleWindow() {
     g_windowVisible = true;
-    g_windowCv.notify_all();
+    signalSubtitleThread();
     // 重新定位到任务区右下角（必须异步等待窗口真正创建后再移动）
     std::thread([] {
         for (int i = 0; i < 50; ++i) {
@@ -119,11 +150,38 @@ void showSubtitleWindow() {
 
 void hideSubtitleWindow() {
     g_windowVisible = false;
-    g_windowCv.notify_all();
+    signalSubtitleThread();
+}
+
+// 隐藏期间只更新按键集合、统计和按键绑定，不生成字幕
+static void drainKeyEventsHidden() {
+    KeyEvent keyEvent;
+    while (g_keyEvents.pop(keyEvent)) {
+        uint32_t vk = keyEvent.vkCode;
+        if (!keyEvent.down) {
+            g_pressedKeys.reset(vk);
+            continue;
+        }
+        if (g_pressedKeys.test(vk)) continue; // 长按自动重复
+        g_pressedKeys.set(vk);
+        g_keyStats.onKeyDown(vk, keyEvent.time, g_pressedKeys);
+        feedKeyBindings(vk, keyEvent.time, g_pressedKeys);
+    }
+}
+
+// 等待显示请求，期间继续处理键盘事件并按时落盘
+static void waitWhileHidden() {
+    while (!g_windowVisible && !g_threadExit) {
+        drainKeyEventsHidden();
+        g_keyStats.flushIfDue(KEY_STATS_PATH, GetTickCount());
+        uint32_t flushWait = g_keyStats.msUntilFlush(GetTickCount());
+        WaitForSingleObject(g_keyEventSignal, flushWait == UINT32_MAX ? INFINITE : flushWait);
+    }
 }
 
 void subtitleWindowThreadFunc() {
     updateLockStates(); // 启动时获取一次锁定键状态
+    g_keyStats.load(KEY_STATS_PATH); // 在上次的统计上继续累计
 
     g_hookThreadExit = false;
     g_hookThread = std::thread(hookThread); // 启动钩子线程
@@ -132,10 +190,7 @@ void subtitleWindowThreadFunc() {
 
     while (!g_threadExit) {
         // 等待显示请求
-        {
-            std::unique_lock lk(g_windowMutex);
-            g_windowCv.wait(lk, [] { return g_windowVisible || g_threadExit; });
-        }
+        waitWhileHidden();
         if (g_threadExit) break;
 
         // 创建窗口
@@ -161,9 +216,18 @@ void subtitleWindowThreadFunc() {
 
         // 字幕队列
         std::deque<SubtitleEntry> subtitles;
+        SubtitleGeometry geometry;
+
+        // 历史栏和当前栏分别绘制到各自的离屏纹理，只回读发生变化的部分
+        sf::RenderTexture historyTexture;
+        sf::RenderTexture barTexture;
+        sf::Image frameImage;
+        bool historyDirty = true;
+        bool barDirty = true;
+        bool imeStale = true; // 下次按键时强制重新采样输入法状态
         sf::Clock clock;
 
-        std::map<DWORD, sf::Time> keyDownAbsTime;
+        KeyDownTimes keyDownAbsTime;
         sf::Clock globalClock;
 
         // 拖动相关变量
@@ -174,9 +238,11 @@ void subtitleWindowThreadFunc() {
         // 保持窗口置顶
         SetWindowPos(hwnd, HWND_TOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE);
 
+        // 隐藏期间按键集合一直在跟踪，只需重新同步锁定键状态
+        updateLockStates();
+
         while (window->isOpen() && !g_threadExit && g_windowVisible) {
             sf::Event event{};
-            std::string subtitleText;
 
             float baseY = static_cast<float>(window->getSize().y) - 80;
             float subtitleMargin = 6.f;
@@ -205,19 +271,51 @@ void subtitleWindowThreadFunc() {
                 if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
                     dragging = false;
                 }
+                // 拖动只移动窗口，内容不变，无需重绘
                 if (event.type == sf::Event::MouseMoved && dragging) {
                     sf::Vector2i mouseNow = sf::Mouse::getPosition();
                     sf::Vector2i delta = mouseNow - dragStartMouse;
                     SetWindowPos(hwnd, HWND_TOPMOST, dragStartWindow.x + delta.x, dragStartWindow.y + delta.y, 0, 0, SWP_NOSIZE | SWP_NOZORDER);
                 }
+                if (event.type == sf::Event::Resized) {
+                    historyDirty = barDirty = true;
+                }
             }
-
-            // 获取全局按键状态
-            std::set<DWORD> pressedCopy;
-            {
-                std::lock_guard lock(g_keyMutex);
-                pressedCopy = g_pressedKeys;
+            if (!window->isOpen()) break;
+
+            // 按顺序重放钩子事件，帧间的每次按下都单独弹出字幕
+            KeyEvent keyEvent;
+            while (g_keyEvents.pop(keyEvent)) {
+                DWORD vk = keyEvent.vkCode;
+                if (!keyEvent.down) {
+                    if (g_pressedKeys.test(vk)) barDirty = true;
+                    g_pressedKeys.reset(vk);
+                    // 修饰键（Shift、Ctrl+Space等）松开后输入法模式可能已切换
+                    if (modifyVkTables().contains(static_cast<int>(vk))) imeStale = true;
+                    continue;
+                }
+                if (g_pressedKeys.test(vk)) continue; // 长按自动重复
+                g_pressedKeys.set(vk);
+                g_keyStats.onKeyDown(vk, keyEvent.time, g_pressedKeys);
+                feedKeyBindings(vk, keyEvent.time, g_pressedKeys);
+
+                // 切换输入法状态（只在按键时采样）
+                setSymbolMap(imeStale);
+                imeStale = false;
+                if (vk == VK_CAPITAL || vk == VK_NUMLOCK || vk == VK_SCROLL) {
+                    applyLockBits(keyEvent.lockBits);
+                }
+                // 使用独立函数处理弹出逻辑
+                handleNewlyPressed(
+                    KeyState::single(vk),
+                    g_pressedKeys,
+                    subtitles,
+                    g_maxSubtitles,
+                    g_subtitleDuration
+                );
+                historyDirty = barDirty = true;
             }
+            const KeyState& pressedCopy = g_pressedKeys;
 
             // 记录每个键的绝对按下时间
             updateKeyDownAbsTime(pressedCopy, keyDownAbsTime, globalClock);
@@ -225,70 +323,72 @@ void subtitleWindowThreadFunc() {
             // 清理已松开的键
             cleanReleasedKeys(pressedCopy, keyDownAbsTime);
 
-            // 检测新按下的键
-            static std::set<DWORD> prevPressed;
-            std::set<DWORD> newlyPressed;
-            std::set_difference(
-                pressedCopy.begin(), pressedCopy.end(),
-                prevPressed.begin(), prevPressed.end(),
-                std::inserter(newlyPressed, newlyPressed.end())
-            );
-
-            // 切换输入法状态
-            setSymbolMap();
-
-            // 使用独立函数处理弹出逻辑
-            handleNewlyPressed(
-                newlyPressed,
-                pressedCopy,
-                subtitles,
-                g_maxSubtitles,
-                g_subtitleDuration
-            );
-
-            prevPressed = pressedCopy;
-
-            // 更新时间并移除过期字幕
-            updateAndCleanSubtitles(subtitles, clock);
-
-            // 可视化显示
-            window->clear(sf::Color::Transparent);
-
-            // 绘制到离屏纹理
-            static sf::RenderTexture renderTexture;
-            if (renderTexture.getSize() != window->getSize())
-                renderTexture.create(window->getSize().x, window->getSize().y);
-            renderTexture.clear(sf::Color::Transparent);
-
-            // 绘制历史栏内容
-            drawHistorySubtitles(renderTexture, subtitles, fontZh, fontEn, baseY,
-                g_subtitleDuration, subtitleMargin, subtitleWidth, subtitleLeft);
-
-            // 绘制当前栏内容
-            drawCurrentBar(renderTexture, fontZh, fontEn, pressedCopy, subtitleWidth, subtitleHeight, subtitleLeft);
-
-            renderTexture.display();
-
-            // 用 setClickThrough 实现窗口级别的半透明和点击穿透
-            setClickThrough(hwnd, renderTexture.getTexture().copyToImage());
-
-            // 主窗口只负责显示
-            window->clear(sf::Color::Transparent);
-            sf::Sprite spr(renderTexture.getTexture());
-            window->draw(spr);
-            window->display();
+            // 更新时间并移除过期字幕（透明度跨过量化级时才需要重绘）
+            if (updateAndCleanSubtitles(subtitles, clock, g_subtitleDuration))
+                historyDirty = true;
+
+            if (historyDirty || barDirty) {
+                // 历史栏和当前栏的分界（当前栏高度为1.2倍）
+                sf::Vector2u size = window->getSize();
+                auto splitY = static_cast<unsigned>(static_cast<float>(size.y) - subtitleHeight * 1.2f);
+                if (frameImage.getSize() != size) {
+                    frameImage.create(size.x, size.y, sf::Color::Transparent);
+                    historyTexture.create(size.x, splitY);
+                    barTexture.create(size.x, size.y - splitY);
+                    geometry = SubtitleGeometry();
+                    for (auto& entry : subtitles) entry.built = false;
+                    historyDirty = barDirty = true;
+                }
+
+                // 绘制历史栏内容
+                if (historyDirty) {
+                    historyTexture.clear(sf::Color::Transparent);
+                    drawHistorySubtitles(historyTexture, geometry, subtitles, fontZh, fontEn, baseY,
+                        g_subtitleDuration, subtitleMargin, subtitleWidth, subtitleLeft);
+                    historyTexture.display();
+                    frameImage.copy(historyTexture.getTexture().copyToImage(), 0, 0);
+                }
+
+                // 绘制当前栏内容
+                if (barDirty) {
+                    barTexture.clear(sf::Color::Transparent);
+                    drawCurrentBar(barTexture, geometry, fontZh, fontEn, pressedCopy, subtitleWidth, subtitleHeight, subtitleLeft);
+                    barTexture.display();
+                    frameImage.copy(barTexture.getTexture().copyToImage(), 0, splitY);
+                }
+                historyDirty = barDirty = false;
+
+                // 用 setClickThrough 实现窗口级别的半透明和点击穿透
+                setClickThrough(hwnd, frameImage);
+
+                // 主窗口只负责显示
+                window->clear(sf::Color::Transparent);
+                sf::Sprite historySpr(historyTexture.getTexture());
+                sf::Sprite barSpr(barTexture.getTexture());
+                barSpr.setPosition(0.f, static_cast<float>(splitY));
+                window->draw(historySpr);
+                window->draw(barSpr);
+                window->display();
+            }
+
+            // 统计数据定期落盘
+            g_keyStats.flushIfDue(KEY_STATS_PATH, GetTickCount());
+
+            // 无内容变化时休眠：有字幕在淡出则按帧间隔醒来检查量化级，否则一直等到键盘事件、窗口消息或落盘时间
+            DWORD timeout = subtitles.empty() ? INFINITE : 33;
+            uint32_t flushWait = g_keyStats.msUntilFlush(GetTickCount());
+            if (flushWait != UINT32_MAX) timeout = std::min<DWORD>(timeout, flushWait);
+            MsgWaitForMultipleObjectsEx(1, &g_keyEventSignal, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
         }
-        
-        // 隐藏窗口
+
+        // 隐藏窗口前先把统计写盘
+        if (g_keyStats.msUntilFlush(GetTickCount()) != UINT32_MAX) g_keyStats.save(KEY_STATS_PATH);
         ShowWindow(hwnd, SW_HIDE);
         delete window;
         g_subtitleHwnd = nullptr;
 
         // 等待下次显示
-        if (!g_threadExit) {
-            std::unique_lock lk(g_windowMutex);
-            g_windowCv.wait(lk, [] { return g_windowVisible || g_threadExit; });
-        }
+        waitWhileHidden();
     }
     g_subtitleHwnd = nullptr;
 
@@ -301,6 +401,7 @@ void subtitleWindowThreadFunc() {
 }
 
 void initSubtitleWindow(float subtitleDuration, size_t maxSubtitles, int modeWidth) {
+    if (!g_keyEventSignal) g_keyEventSignal = CreateEvent(nullptr, FALSE, FALSE, nullptr);
     g_subtitleDuration = subtitleDuration;
     g_maxSubtitles = maxSubtitles;
     g_modeWidth = modeWidth;
@@ -322,7 +423,7 @@ void forceCloseSubtitleWindow() {
     }
     g_threadExit = true;
     g_windowVisible = false;
-    g_windowCv.notify_all();
+    signalSubtitleThread();
     if (g_subtitleThread.joinable()) {
         g_subtitleThread.join();
     }
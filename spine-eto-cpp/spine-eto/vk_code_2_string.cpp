@@ -1,384 +1,403 @@
 #include <windows.h>
 
+#include <array>
+#include <cctype>
+#include <string_view>
+
 #include "json.hpp"
 #include "vk_code_2_string.h"
 
-// 主表实现 (https://learn.microsoft.com/en-us/windows/win32/inputdev/virtual-key-codes)
-static VkTable g_mainTable; // 全局主表
-static bool g_mainTableInitialized = false;
+namespace {
 
-static void initMainTableFromConfig(const nlohmann::json& config) {
-    // 读取自定义主映射表配置
-    std::vector<std::string> vkTableNames;
-    if (config.contains("VK_TABLES") && config["VK_TABLES"].is_array()) {
-        for (const auto& item : config["VK_TABLES"]) {
-            if (item.is_string()) vkTableNames.push_back(item.get<std::string>());
-        }
-    }
-    std::vector<const VkTable*> vkTablesToCombine;
-    for (const auto& name : vkTableNames) {
-        if (name == "main") vkTablesToCombine.push_back(&getMainVkTable());
-        else if (name == "mouse") vkTablesToCombine.push_back(&mouseVkTables());
-        else if (name == "imeVk") vkTablesToCombine.push_back(&imeVkTables());
-        else if (name == "direct") vkTablesToCombine.push_back(&directionVkTables());
-        else if (name == "mainNum") vkTablesToCombine.push_back(&mainNumVkTables());
-        else if (name == "alphabet") vkTablesToCombine.push_back(&alphabetVkTables());
-        else if (name == "liteNum") vkTablesToCombine.push_back(&liteNumVkTables());
-        else if (name == "liteNumOp") vkTablesToCombine.push_back(&liteNumOpVkTables());
-        else if (name == "funcNum") vkTablesToCombine.push_back(&funcNumVkTables());
-        else if (name == "highFunc") vkTablesToCombine.push_back(&highFuncVkTables());
-        else if (name == "midFunc") vkTablesToCombine.push_back(&midFuncVkTables());
-        else if (name == "modify") vkTablesToCombine.push_back(&modifyVkTables());
-        else if (name == "browser") vkTablesToCombine.push_back(&browserVkTables());
-        else if (name == "appVk") vkTablesToCombine.push_back(&appVkTables());
-        else if (name == "inter") vkTablesToCombine.push_back(&interVkTables());
-        else if (name == "other") vkTablesToCombine.push_back(&otherVkTables());
-    }
-    if (!vkTablesToCombine.empty()) {
-        g_mainTable = combineVkTables(vkTablesToCombine);
-        g_mainTableInitialized = true;
-    }
-}
+// VK条目：VK码、显示名称、所属分类
+struct VkEntry {
+    int vk;
+    std::string_view name;
+    uint32_t category;
+};
 
-// 提供初始化接口，供main.cpp调用
-void initVkMainTableFromJson(const nlohmann::json& config) {
-    initMainTableFromConfig(config);
-}
+// 全部VK条目 (https://learn.microsoft.com/en-us/windows/win32/inputdev/virtual-key-codes)
+// 各分表不再单独存储，而是本表按分类掩码筛选
+constexpr VkEntry kVkEntries[] = {
 
-// 获取主映射表
-const VkTable& getMainVkTable() {
-    if (g_mainTableInitialized) {
-        return g_mainTable;
-    }
-    static VkTable vkMap = {
+    // 鼠标按键区（0x00 ~ 0x06）
+    {VK_LBUTTON, "MouseLeft", VK_CAT_MOUSE}, {VK_RBUTTON, "MouseRight", VK_CAT_MOUSE}, {VK_CANCEL, "MouseBreak", VK_CAT_MOUSE},
+    {VK_MBUTTON, "MouseMiddle", VK_CAT_MOUSE}, {VK_XBUTTON1, "MouseX1", VK_CAT_MOUSE}, {VK_XBUTTON2, "MouseX2", VK_CAT_MOUSE},
 
-        // 鼠标按键区（0x00 ~ 0x06）
-        {VK_LBUTTON, "MouseLeft"}, {VK_RBUTTON, "MouseRight"}, {VK_CANCEL, "MouseBreak"},
-        {VK_MBUTTON, "MouseMiddle"}, {VK_XBUTTON1, "MouseX1"}, {VK_XBUTTON2, "MouseX2"},
+    // Reserved: 0x07
 
-        // Reserved: 0x07
+    // Back键和Tab键（0x08 ~ 0x09）
+    {VK_BACK, "Back", VK_CAT_HIGH_FUNC}, {VK_TAB, "Tab", VK_CAT_HIGH_FUNC},
 
-        // Back键和Tab键（0x08 ~ 0x09）
-        {VK_BACK, "Back"}, {VK_TAB, "Tab"},
+    // Reserved: 0x0A ~ 0x0B
 
-        // Reserved: 0x0A ~ 0x0B
+    // Clear键和Enter键（0x0C ~ 0x0D）
+    {VK_CLEAR, "Clear", VK_CAT_MID_FUNC}, {VK_RETURN, "Enter", VK_CAT_HIGH_FUNC},
 
-        // Clear键和Enter键（0x0C ~ 0x0D）
-        {VK_CLEAR, "Clear"}, {VK_RETURN, "Enter"},
+    // Unassigned: 0x0E ~ 0x0F
 
-        // Unassigned: 0x0E ~ 0x0F
+    // Shift键和Ctrl键和Alt键（0x10 ~ 0x12）
+    {VK_SHIFT, "Shift", VK_CAT_MODIFY}, {VK_CONTROL, "Ctrl", VK_CAT_MODIFY}, {VK_MENU, "Alt", VK_CAT_MODIFY},
 
-        // Shift键和Ctrl键和Alt键（0x10 ~ 0x12）
-        {VK_SHIFT, "Shift"}, {VK_CONTROL, "Ctrl"}, {VK_MENU, "Alt"},
+    // Pause键和CapsLock键（0x13 ~ 0x14）
+    {VK_PAUSE, "Pause", VK_CAT_MID_FUNC}, {VK_CAPITAL, "CapsLock", VK_CAT_HIGH_FUNC},
 
-        // Pause键和CapsLock键（0x13 ~ 0x14）
-        {VK_PAUSE, "Pause"}, {VK_CAPITAL, "CapsLock"},
+    // 输入法切换键区（0x15 ~ 0x1A）
+    {VK_KANA, "Kana", VK_CAT_IME}, {VK_HANGUL, "Hangul", VK_CAT_IME}, {VK_IME_ON, "IMEOn", VK_CAT_IME},
+    {VK_JUNJA, "Junja", VK_CAT_IME}, {VK_FINAL, "Final", VK_CAT_IME},
+    {VK_HANJA, "Hanja", VK_CAT_IME}, {VK_KANJI, "Kanji", VK_CAT_IME}, {VK_IME_OFF, "IMEOff", VK_CAT_IME},
 
-        // 输入法切换键区（0x15 ~ 0x1A）
-        {VK_KANA, "Kana"}, {VK_HANGUL, "Hangul"}, {VK_IME_ON, "IMEOn"},
-        {VK_JUNJA, "Junja"}, {VK_FINAL, "Final"},
-        {VK_HANJA, "Hanja"}, {VK_KANJI, "Kanji"}, {VK_IME_OFF, "IMEOff"},
+    // Escape键（0x1B）
+    {VK_ESCAPE, "Escape", VK_CAT_HIGH_FUNC},
 
-        // Escape键（0x1B）
-        {VK_ESCAPE, "Escape"},
+    // 输入法操作键区（0x1C ~ 0x1F）
+    {VK_CONVERT, "Convert", VK_CAT_IME}, {VK_NONCONVERT, "NonConvert", VK_CAT_IME},
+    {VK_ACCEPT, "Accept", VK_CAT_IME}, {VK_MODECHANGE, "ModeChange", VK_CAT_IME},
 
-        // 输入法操作键区（0x1C ~ 0x1F）
-        {VK_CONVERT, "Convert"}, {VK_NONCONVERT, "NonConvert"},
-        {VK_ACCEPT, "Accept"}, {VK_MODECHANGE, "ModeChange"},
+    // 浏览键区（0x20 ~ 0x24）
+    {VK_SPACE, "Space", VK_CAT_HIGH_FUNC}, {VK_PRIOR, "PageUp", VK_CAT_HIGH_FUNC}, {VK_NEXT, "PageDown", VK_CAT_HIGH_FUNC},
+    {VK_END, "End", VK_CAT_HIGH_FUNC}, {VK_HOME, "Home", VK_CAT_HIGH_FUNC},
 
-        // 浏览键区（0x20 ~ 0x24）
-        {VK_SPACE, "Space"}, {VK_PRIOR, "PageUp"}, {VK_NEXT, "PageDown"},
-        {VK_END, "End"}, {VK_HOME, "Home"},
+    // 方向键区（0x25 ~ 0x28）
+    {VK_LEFT, "Left", VK_CAT_DIRECTION}, {VK_UP, "Up", VK_CAT_DIRECTION}, {VK_RIGHT, "Right", VK_CAT_DIRECTION}, {VK_DOWN, "Down", VK_CAT_DIRECTION},
 
-        // 方向键区（0x25 ~ 0x28）
-        {VK_LEFT, "Left"}, {VK_UP, "Up"}, {VK_RIGHT, "Right"}, {VK_DOWN, "Down"},
+    // 编辑快捷键区（0x29 ~ 0x2F）
+    {VK_SELECT, "Select", VK_CAT_MID_FUNC}, {VK_PRINT, "Print", VK_CAT_MID_FUNC}, {VK_EXECUTE, "Execute", VK_CAT_MID_FUNC},
+    {VK_SNAPSHOT, "Snapshot", VK_CAT_MID_FUNC}, {VK_INSERT, "Insert", VK_CAT_HIGH_FUNC}, {VK_DELETE, "Delete", VK_CAT_HIGH_FUNC},
+    {VK_HELP, "Help", VK_CAT_MID_FUNC},
 
-        // 编辑快捷键区（0x29 ~ 0x2F）
-        {VK_SELECT, "Select"}, {VK_PRINT, "Print"}, {VK_EXECUTE, "Execute"},
-        {VK_SNAPSHOT, "Snapshot"}, {VK_INSERT, "Insert"}, {VK_DELETE, "Delete"},
-        {VK_HELP, "Help"},
+    // 主键盘数字区（0x30 ~ 0x39）
+    {'1', "1!", VK_CAT_MAIN_NUM}, {'2', "2@", VK_CAT_MAIN_NUM}, {'3', "3#", VK_CAT_MAIN_NUM}, {'4', "4$", VK_CAT_MAIN_NUM}, {'5', "5%", VK_CAT_MAIN_NUM},
+    {'6', "6^", VK_CAT_MAIN_NUM}, {'7', "7&", VK_CAT_MAIN_NUM}, {'8', "8*", VK_CAT_MAIN_NUM}, {'9', "9(", VK_CAT_MAIN_NUM}, {'0', "0)", VK_CAT_MAIN_NUM},
 
-        // 主键盘数字区（0x30 ~ 0x39）
-        {'1', "1!"}, {'2', "2@"}, {'3', "3#"}, {'4', "4$"}, {'5', "5%"},
-        {'6', "6^"}, {'7', "7&"}, {'8', "8*"}, {'9', "9("}, {'0', "0)"},
+    // Reserved: 0x3A ~ 0x40
 
-        // Reserved: 0x3A ~ 0x40
+    // 主键盘字母区（0x41 ~ 0x5A）
+    {'A', "A", VK_CAT_ALPHABET}, {'B', "B", VK_CAT_ALPHABET}, {'C', "C", VK_CAT_ALPHABET}, {'D', "D", VK_CAT_ALPHABET}, {'E', "E", VK_CAT_ALPHABET}, {'F', "F", VK_CAT_ALPHABET},
+    {'G', "G", VK_CAT_ALPHABET}, {'H', "H", VK_CAT_ALPHABET}, {'I', "I", VK_CAT_ALPHABET}, {'J', "J", VK_CAT_ALPHABET}, {'K', "K", VK_CAT_ALPHABET}, {'L', "L", VK_CAT_ALPHABET},
+    {'M', "M", VK_CAT_ALPHABET}, {'N', "N", VK_CAT_ALPHABET}, {'O', "O", VK_CAT_ALPHABET}, {'P', "P", VK_CAT_ALPHABET}, {'Q', "Q", VK_CAT_ALPHABET}, {'R', "R", VK_CAT_ALPHABET},
+    {'S', "S", VK_CAT_ALPHABET}, {'T', "T", VK_CAT_ALPHABET}, {'U', "U", VK_CAT_ALPHABET}, {'V', "V", VK_CAT_ALPHABET}, {'W', "W", VK_CAT_ALPHABET}, {'X', "X", VK_CAT_ALPHABET},
+    {'Y', "Y", VK_CAT_ALPHABET}, {'Z', "Z", VK_CAT_ALPHABET},
 
-        // 主键盘字母区（0x41 ~ 0x5A）
-        {'A', "A"}, {'B', "B"}, {'C', "C"}, {'D', "D"}, {'E', "E"}, {'F', "F"},
-        {'G', "G"}, {'H', "H"}, {'I', "I"}, {'J', "J"}, {'K', "K"}, {'L', "L"},
-        {'M', "M"}, {'N', "N"}, {'O', "O"}, {'P', "P"}, {'Q', "Q"}, {'R', "R"},
-        {'S', "S"}, {'T', "T"}, {'U', "U"}, {'V', "V"}, {'W', "W"}, {'X', "X"},
-        {'Y', "Y"}, {'Z', "Z"},
+    // 重要系统键区（0x5B ~ 0x5D）
+    {VK_LWIN, "LWin", VK_CAT_MODIFY}, {VK_RWIN, "RWin", VK_CAT_MODIFY}, {VK_APPS, "Apps", VK_CAT_MODIFY},
 
-        // 重要系统键区（0x5B ~ 0x5D）
-        {VK_LWIN, "LWin"}, {VK_RWIN, "RWin"}, {VK_APPS, "Apps"},
+    // Reserved: 0x5E
 
-        // Reserved: 0x5E
+    // 休眠键（0x5F）
+    {VK_SLEEP, "Sleep", VK_CAT_OTHER},
 
-        // 休眠键（0x5F）
-        {VK_SLEEP, "Sleep"},
+    // 数字键盘区（0x60 ~ 0x69）
+    {VK_NUMPAD0, "Num0", VK_CAT_LITE_NUM}, {VK_NUMPAD1, "Num1", VK_CAT_LITE_NUM}, {VK_NUMPAD2, "Num2", VK_CAT_LITE_NUM}, {VK_NUMPAD3, "Num3", VK_CAT_LITE_NUM},
+    {VK_NUMPAD4, "Num4", VK_CAT_LITE_NUM}, {VK_NUMPAD5, "Num5", VK_CAT_LITE_NUM}, {VK_NUMPAD6, "Num6", VK_CAT_LITE_NUM}, {VK_NUMPAD7, "Num7", VK_CAT_LITE_NUM},
+    {VK_NUMPAD8, "Num8", VK_CAT_LITE_NUM}, {VK_NUMPAD9, "Num9", VK_CAT_LITE_NUM},
 
-        // 数字键盘区（0x60 ~ 0x69）
-        {VK_NUMPAD0, "Num0"}, {VK_NUMPAD1, "Num1"}, {VK_NUMPAD2, "Num2"}, {VK_NUMPAD3, "Num3"},
-        {VK_NUMPAD4, "Num4"}, {VK_NUMPAD5, "Num5"}, {VK_NUMPAD6, "Num6"}, {VK_NUMPAD7, "Num7"},
-        {VK_NUMPAD8, "Num8"}, {VK_NUMPAD9, "Num9"},
+    // 数字键盘操作符区（0x6A ~ 0x6F）
+    {VK_MULTIPLY, "Num*", VK_CAT_LITE_NUM_OP}, {VK_ADD, "Num+", VK_CAT_LITE_NUM_OP}, {VK_SEPARATOR, "Separator", VK_CAT_LITE_NUM_OP},
+    {VK_SUBTRACT, "Num-", VK_CAT_LITE_NUM_OP}, {VK_DECIMAL, "Num.", VK_CAT_LITE_NUM_OP}, {VK_DIVIDE, "Num/", VK_CAT_LITE_NUM_OP},
 
-        // 数字键盘操作符区（0x6A ~ 0x6F）
-        {VK_MULTIPLY, "Num*"}, {VK_ADD, "Num+"}, {VK_SEPARATOR, "Separator"},
-        {VK_SUBTRACT, "Num-"}, {VK_DECIMAL, "Num."}, {VK_DIVIDE, "Num/"},
+    // 常用Function键区（0x70 ~ 0x7B）
+    {VK_F1, "F1", VK_CAT_FUNC_NUM}, {VK_F2, "F2", VK_CAT_FUNC_NUM}, {VK_F3, "F3", VK_CAT_FUNC_NUM}, {VK_F4, "F4", VK_CAT_FUNC_NUM},
+    {VK_F5, "F5", VK_CAT_FUNC_NUM}, {VK_F6, "F6", VK_CAT_FUNC_NUM}, {VK_F7, "F7", VK_CAT_FUNC_NUM}, {VK_F8, "F8", VK_CAT_FUNC_NUM}, 
+    {VK_F9, "F9", VK_CAT_FUNC_NUM}, {VK_F10, "F10", VK_CAT_FUNC_NUM}, {VK_F11, "F11", VK_CAT_FUNC_NUM}, {VK_F12, "F12", VK_CAT_FUNC_NUM},
+
+    // 少用Function键区（0x7C ~ 0x87）
+    {VK_F13, "F13", VK_CAT_FUNC_NUM}, {VK_F14, "F14", VK_CAT_FUNC_NUM}, {VK_F15, "F15", VK_CAT_FUNC_NUM}, {VK_F16, "F16", VK_CAT_FUNC_NUM},
+    {VK_F17, "F17", VK_CAT_FUNC_NUM}, {VK_F18, "F18", VK_CAT_FUNC_NUM}, {VK_F19, "F19", VK_CAT_FUNC_NUM}, {VK_F20, "F20", VK_CAT_FUNC_NUM},
+    {VK_F21, "F21", VK_CAT_FUNC_NUM}, {VK_F22, "F22", VK_CAT_FUNC_NUM}, {VK_F23, "F23", VK_CAT_FUNC_NUM}, {VK_F24, "F24", VK_CAT_FUNC_NUM},
+    
+    // Reserved: 0x88 ~ 0x8F
 
-        // 常用Function键区（0x70 ~ 0x7B）
-        {VK_F1, "F1"}, {VK_F2, "F2"}, {VK_F3, "F3"}, {VK_F4, "F4"},
-        {VK_F5, "F5"}, {VK_F6, "F6"}, {VK_F7, "F7"}, {VK_F8, "F8"}, 
-        {VK_F9, "F9"}, {VK_F10, "F10"}, {VK_F11, "F11"}, {VK_F12, "F12"},
+    // 数字键盘锁和滚动操作锁（0x90 ~ 0x91）
+    {VK_NUMLOCK, "NumLock", VK_CAT_MID_FUNC}, {VK_SCROLL, "ScrollLock", VK_CAT_MID_FUNC},
 
-        // 少用Function键区（0x7C ~ 0x87）
-        {VK_F13, "F13"}, {VK_F14, "F14"}, {VK_F15, "F15"}, {VK_F16, "F16"},
-        {VK_F17, "F17"}, {VK_F18, "F18"}, {VK_F19, "F19"}, {VK_F20, "F20"},
-        {VK_F21, "F21"}, {VK_F22, "F22"}, {VK_F23, "F23"}, {VK_F24, "F24"},
-        
-        // Reserved: 0x88 ~ 0x8F
+    // OEM specific: 0x92 ~ 0x96
 
-        // 数字键盘锁和滚动操作锁（0x90 ~ 0x91）
-        {VK_NUMLOCK, "NumLock"}, {VK_SCROLL, "ScrollLock"},
+    // Unassigned: 0x97 ~ 0x9F
 
-        // OEM specific: 0x92 ~ 0x96
+    // 重要功能键区（0xA0 ~ 0xA5）
+    {VK_LSHIFT, "LShift", VK_CAT_MODIFY}, {VK_RSHIFT, "RShift", VK_CAT_MODIFY},
+    {VK_LCONTROL, "LCtrl", VK_CAT_MODIFY}, {VK_RCONTROL, "RCtrl", VK_CAT_MODIFY},
+    {VK_LMENU, "LAlt", VK_CAT_MODIFY}, {VK_RMENU, "RAlt", VK_CAT_MODIFY},
 
-        // Unassigned: 0x97 ~ 0x9F
+    // 浏览器控制键区（0xA6 ~ 0xAC）
+    {VK_BROWSER_BACK, "BrowserBack", VK_CAT_BROWSER}, {VK_BROWSER_FORWARD, "BrowserForward", VK_CAT_BROWSER},
+    {VK_BROWSER_REFRESH, "BrowserRefresh", VK_CAT_BROWSER}, {VK_BROWSER_STOP, "BrowserStop", VK_CAT_BROWSER},
+    {VK_BROWSER_SEARCH, "BrowserSearch", VK_CAT_BROWSER}, {VK_BROWSER_FAVORITES, "BrowserFavorites", VK_CAT_BROWSER},
+    {VK_BROWSER_HOME, "BrowserHome", VK_CAT_BROWSER},
 
-        // 重要功能键区（0xA0 ~ 0xA5）
-        {VK_LSHIFT, "LShift"}, {VK_RSHIFT, "RShift"},
-        {VK_LCONTROL, "LCtrl"}, {VK_RCONTROL, "RCtrl"},
-        {VK_LMENU, "LAlt"}, {VK_RMENU, "RAlt"},
+    // 多媒体控制键区（0xAD ~ 0xB7）
+    {VK_VOLUME_MUTE, "VolumeMute", VK_CAT_APP}, {VK_VOLUME_DOWN, "VolumeDown", VK_CAT_APP}, {VK_VOLUME_UP, "VolumeUp", VK_CAT_APP},
+    {VK_MEDIA_NEXT_TRACK, "MediaNext", VK_CAT_APP}, {VK_MEDIA_PREV_TRACK, "MediaPrev", VK_CAT_APP},
+    {VK_MEDIA_STOP, "MediaStop", VK_CAT_APP}, {VK_MEDIA_PLAY_PAUSE, "MediaPlayPause", VK_CAT_APP},
+    {VK_LAUNCH_MAIL, "LaunchMail", VK_CAT_APP}, {VK_LAUNCH_MEDIA_SELECT, "LaunchMedia", VK_CAT_APP},
+    {VK_LAUNCH_APP1, "LaunchApp1", VK_CAT_APP}, {VK_LAUNCH_APP2, "LaunchApp2", VK_CAT_APP},
 
-        // 浏览器控制键区（0xA6 ~ 0xAC）
-        {VK_BROWSER_BACK, "BrowserBack"}, {VK_BROWSER_FORWARD, "BrowserForward"},
-        {VK_BROWSER_REFRESH, "BrowserRefresh"}, {VK_BROWSER_STOP, "BrowserStop"},
-        {VK_BROWSER_SEARCH, "BrowserSearch"}, {VK_BROWSER_FAVORITES, "BrowserFavorites"},
-        {VK_BROWSER_HOME, "BrowserHome"},
+    // Reserved: 0xB8 ~ 0xB9
 
-        // 多媒体控制键区（0xAD ~ 0xB7）
-        {VK_VOLUME_MUTE, "VolumeMute"}, {VK_VOLUME_DOWN, "VolumeDown"}, {VK_VOLUME_UP, "VolumeUp"},
-        {VK_MEDIA_NEXT_TRACK, "MediaNext"}, {VK_MEDIA_PREV_TRACK, "MediaPrev"},
-        {VK_MEDIA_STOP, "MediaStop"}, {VK_MEDIA_PLAY_PAUSE, "MediaPlayPause"},
-        {VK_LAUNCH_MAIL, "LaunchMail"}, {VK_LAUNCH_MEDIA_SELECT, "LaunchMedia"},
-        {VK_LAUNCH_APP1, "LaunchApp1"}, {VK_LAUNCH_APP2, "LaunchApp2"},
+    // 常用符号键区（0xBA ~ 0xC0）
+    {VK_OEM_1, ";:", VK_CAT_INTER}, {VK_OEM_PLUS, "+=", VK_CAT_INTER}, {VK_OEM_COMMA, ",<", VK_CAT_INTER},
+    {VK_OEM_MINUS, "-_", VK_CAT_INTER}, {VK_OEM_PERIOD, ".>", VK_CAT_INTER}, {VK_OEM_2, "/?", VK_CAT_INTER}, {VK_OEM_3, "`~", VK_CAT_INTER},
+    
+    // Reserved: 0xC1 ~ 0xDA
 
-        // Reserved: 0xB8 ~ 0xB9
+    // 括号和引号键区（0xDB ~ 0xDF）
+    {VK_OEM_4, "[{", VK_CAT_INTER}, {VK_OEM_5, "\\|", VK_CAT_INTER}, {VK_OEM_6, "]}", VK_CAT_INTER},
+    {VK_OEM_7, "'\"", VK_CAT_INTER}, {VK_OEM_8, "MiscChar", VK_CAT_INTER},
 
-        // 常用符号键区（0xBA ~ 0xC0）
-        {VK_OEM_1, ";:"}, {VK_OEM_PLUS, "+="}, {VK_OEM_COMMA, ",<"},
-        {VK_OEM_MINUS, "-_"}, {VK_OEM_PERIOD, ".>"}, {VK_OEM_2, "/?"}, {VK_OEM_3, "`~"},
-        
-        // Reserved: 0xC1 ~ 0xDA
+    // Reserved: 0xE0
 
-        // 括号和引号键区（0xDB ~ 0xDF）
-        {VK_OEM_4, "[{"}, {VK_OEM_5, "\\|"}, {VK_OEM_6, "]}"},
-        {VK_OEM_7, "'\""}, {VK_OEM_8, "MiscChar"},
+    // OEM specific: 0xE1
+    
+    // RT102键键盘上的尖括号键或反斜杠键: 0xE2
+    {VK_OEM_102, "RT102", VK_CAT_OTHER},
 
-        // Reserved: 0xE0
+    // OEM specific: 0xE3 ~ 0xE4
 
-        // OEM specific: 0xE1
-        
-        // RT102键键盘上的尖括号键或反斜杠键: 0xE2
-        {VK_OEM_102, "RT102"},
+    // 查看输入法是否对当前按键做处理: 0xE5
+    {VK_PROCESSKEY, "ProcessKey", VK_CAT_OTHER},
 
-        // OEM specific: 0xE3 ~ 0xE4
+    // OEM specific: 0xE6
 
-        // 查看输入法是否对当前按键做处理: 0xE5
-        {VK_PROCESSKEY, "ProcessKey"},
+    // Packet键，用于传递Unicode字符: 0xE7
+    {VK_PACKET, "Packet", VK_CAT_OTHER},
 
-        // OEM specific: 0xE6
+    // Unassigned: 0xE8
 
-        // Packet键，用于传递Unicode字符: 0xE7
-        {VK_PACKET, "Packet"},
+    // OEM specific: 0xE9 ~ 0xF5
 
-        // Unassigned: 0xE8
+    // 其余虚拟键键区（0xF6 ~ 0xFE）
+    {VK_ATTN, "Attn", VK_CAT_OTHER}, {VK_CRSEL, "CrSel", VK_CAT_OTHER}, {VK_EXSEL, "ExSel", VK_CAT_OTHER},
+    {VK_EREOF, "EraseEOF", VK_CAT_OTHER}, {VK_PLAY, "Play", VK_CAT_OTHER}, {VK_ZOOM, "Zoom", VK_CAT_OTHER},
+    {VK_NONAME, "NoName", VK_CAT_OTHER}, {VK_PA1, "PA1", VK_CAT_OTHER}, {VK_OEM_CLEAR, "OEMClear", VK_CAT_OTHER}
 
-        // OEM specific: 0xE9 ~ 0xF5
+};
 
-        // 其余虚拟键键区（0xF6 ~ 0xFE）
-        {VK_ATTN, "Attn"}, {VK_CRSEL, "CrSel"}, {VK_EXSEL, "ExSel"},
-        {VK_EREOF, "EraseEOF"}, {VK_PLAY, "Play"}, {VK_ZOOM, "Zoom"},
-        {VK_NONAME, "NoName"}, {VK_PA1, "PA1"}, {VK_OEM_CLEAR, "OEMClear"}
-        
-    };
-    
-    return vkMap;
+// 编译期生成256项名称表（同值别名如 Kana/Hangul 取先出现者）
+constexpr auto kVkNames = [] {
+    std::array<std::string_view, 256> names{};
+    for (const auto& e : kVkEntries) {
+        if (names[e.vk].empty()) names[e.vk] = e.name;
+    }
+    return names;
+}();
+
+// 编译期生成256项分类表
+constexpr auto kVkCategories = [] {
+    std::array<uint32_t, 256> categories{};
+    for (const auto& e : kVkEntries) categories[e.vk] |= e.category;
+    return categories;
+}();
+
+// 编译期生成未知键的"VK(n)"名称
+constexpr size_t FALLBACK_NAME_LEN = 8;
+constexpr auto kVkFallbackChars = [] {
+    std::array<char, 256 * FALLBACK_NAME_LEN> chars{};
+    for (int vk = 0; vk < 256; ++vk) {
+        char* p = chars.data() + vk * FALLBACK_NAME_LEN;
+        *p++ = 'V'; *p++ = 'K'; *p++ = '(';
+        if (vk >= 100) *p++ = static_cast<char>('0' + vk / 100);
+        if (vk >= 10) *p++ = static_cast<char>('0' + vk / 10 % 10);
+        *p++ = static_cast<char>('0' + vk % 10);
+        *p = ')';
+    }
+    return chars;
+}();
+
+std::string_view fallbackName(int vkCode) {
+    if (vkCode < 0 || vkCode > 255) return "VK(?)";
+    const char* p = kVkFallbackChars.data() + vkCode * FALLBACK_NAME_LEN;
+    size_t len = vkCode >= 100 ? 7 : (vkCode >= 10 ? 6 : 5);
+    return {p, len};
+}
+
+} // namespace
+
+bool VkTable::contains(int vkCode) const {
+    return vkCode >= 0 && vkCode < 256 && (kVkCategories[vkCode] & mask) != 0;
+}
+
+std::string_view VkTable::name(int vkCode) const {
+    return contains(vkCode) ? kVkNames[vkCode] : std::string_view{};
+}
+
+uint32_t vkCategory(int vkCode) {
+    return (vkCode >= 0 && vkCode < 256) ? kVkCategories[vkCode] : 0;
+}
+
+// 主表实现
+static VkTable g_mainTable; // 全局主表（默认包含全部分类）
+
+static void initMainTableFromConfig(const nlohmann::json& config) {
+    // 读取自定义主映射表配置
+    uint32_t mask = 0;
+    if (config.contains("VK_TABLES") && config["VK_TABLES"].is_array()) {
+        for (const auto& item : config["VK_TABLES"]) {
+            if (!item.is_string()) continue;
+            const auto& name = item.get_ref<const std::string&>();
+            if (name == "main") mask |= VK_CAT_ALL;
+            else if (name == "mouse") mask |= VK_CAT_MOUSE;
+            else if (name == "imeVk") mask |= VK_CAT_IME;
+            else if (name == "direct") mask |= VK_CAT_DIRECTION;
+            else if (name == "mainNum") mask |= VK_CAT_MAIN_NUM;
+            else if (name == "alphabet") mask |= VK_CAT_ALPHABET;
+            else if (name == "liteNum") mask |= VK_CAT_LITE_NUM;
+            else if (name == "liteNumOp") mask |= VK_CAT_LITE_NUM_OP;
+            else if (name == "funcNum") mask |= VK_CAT_FUNC_NUM;
+            else if (name == "highFunc") mask |= VK_CAT_HIGH_FUNC;
+            else if (name == "midFunc") mask |= VK_CAT_MID_FUNC;
+            else if (name == "modify") mask |= VK_CAT_MODIFY;
+            else if (name == "browser") mask |= VK_CAT_BROWSER;
+            else if (name == "appVk") mask |= VK_CAT_APP;
+            else if (name == "inter") mask |= VK_CAT_INTER;
+            else if (name == "other") mask |= VK_CAT_OTHER;
+        }
+    }
+    if (mask) {
+        g_mainTable.mask = mask;
+    }
+}
+
+// 提供初始化接口，供main.cpp调用
+void initVkMainTableFromJson(const nlohmann::json& config) {
+    initMainTableFromConfig(config);
+}
+
+// 获取主映射表
+const VkTable& getMainVkTable() {
+    return g_mainTable;
 }
 
 // 鼠标按键分表
 const VkTable& mouseVkTables() {
-    static VkTable table = {
-        {VK_LBUTTON, "MouseLeft"}, {VK_RBUTTON, "MouseRight"}, {VK_CANCEL, "MouseBreak"},
-        {VK_MBUTTON, "MouseMiddle"}, {VK_XBUTTON1, "MouseX1"}, {VK_XBUTTON2, "MouseX2"}
-    };
+    static constexpr VkTable table{VK_CAT_MOUSE};
     return table;
 }
 
 // 输入法相关分表
 const VkTable& imeVkTables() {
-    static VkTable table = {
-        {VK_KANA, "Kana"}, {VK_HANGUL, "Hangul"}, {VK_IME_ON, "IMEOn"},
-        {VK_JUNJA, "Junja"}, {VK_FINAL, "Final"},
-        {VK_HANJA, "Hanja"}, {VK_KANJI, "Kanji"}, {VK_IME_OFF, "IMEOff"},
-        {VK_CONVERT, "Convert"}, {VK_NONCONVERT, "NonConvert"},
-        {VK_ACCEPT, "Accept"}, {VK_MODECHANGE, "ModeChange"}
-    };
+    static constexpr VkTable table{VK_CAT_IME};
     return table;
 }
 
 // 方向键分表
 const VkTable& directionVkTables() {
-    static VkTable table = {
-        {VK_LEFT, "Left"}, {VK_UP, "Up"}, {VK_RIGHT, "Right"}, {VK_DOWN, "Down"}
-    };
+    static constexpr VkTable table{VK_CAT_DIRECTION};
     return table;
 }
 
 // 主键盘数字键分表
 const VkTable& mainNumVkTables() {
-    static VkTable table = {
-        {'1', "1!"}, {'2', "2@"}, {'3', "3#"}, {'4', "4$"}, {'5', "5%"},
-        {'6', "6^"}, {'7', "7&"}, {'8', "8*"}, {'9', "9("}, {'0', "0)"}
-    };
+    static constexpr VkTable table{VK_CAT_MAIN_NUM};
     return table;
 }
 
-// 主键盘数字键分表
+// 主键盘字母键分表
 const VkTable& alphabetVkTables() {
-    static VkTable table = {
-        {'A', "A"}, {'B', "B"}, {'C', "C"}, {'D', "D"}, {'E', "E"}, {'F', "F"},
-        {'G', "G"}, {'H', "H"}, {'I', "I"}, {'J', "J"}, {'K', "K"}, {'L', "L"},
-        {'M', "M"}, {'N', "N"}, {'O', "O"}, {'P', "P"}, {'Q', "Q"}, {'R', "R"},
-        {'S', "S"}, {'T', "T"}, {'U', "U"}, {'V', "V"}, {'W', "W"}, {'X', "X"},
-        {'Y', "Y"}, {'Z', "Z"}
-    };
+    static constexpr VkTable table{VK_CAT_ALPHABET};
     return table;
 }
 
 // 小键盘数字键分表
 const VkTable& liteNumVkTables() {
-    static VkTable table = {
-        {VK_NUMPAD0, "Num0"}, {VK_NUMPAD1, "Num1"}, {VK_NUMPAD2, "Num2"}, {VK_NUMPAD3, "Num3"},
-        {VK_NUMPAD4, "Num4"}, {VK_NUMPAD5, "Num5"}, {VK_NUMPAD6, "Num6"}, {VK_NUMPAD7, "Num7"},
-        {VK_NUMPAD8, "Num8"}, {VK_NUMPAD9, "Num9"}
-    };
+    static constexpr VkTable table{VK_CAT_LITE_NUM};
     return table;
 }
 
-// 小键盘数字键分表
+// 小键盘操作符分表
 const VkTable& liteNumOpVkTables() {
-    static VkTable table = {
-        {VK_MULTIPLY, "Num*"}, {VK_ADD, "Num+"}, {VK_SEPARATOR, "Separator"},
-        {VK_SUBTRACT, "Num-"}, {VK_DECIMAL, "Num."}, {VK_DIVIDE, "Num/"}
-    };
+    static constexpr VkTable table{VK_CAT_LITE_NUM_OP};
     return table;
 }
 
 // Function区分表
 const VkTable& funcNumVkTables() {
-    static VkTable table = {
-        {VK_F1, "F1"}, {VK_F2, "F2"}, {VK_F3, "F3"}, {VK_F4, "F4"},
-        {VK_F5, "F5"}, {VK_F6, "F6"}, {VK_F7, "F7"}, {VK_F8, "F8"},
-        {VK_F9, "F9"}, {VK_F10, "F10"}, {VK_F11, "F11"}, {VK_F12, "F12"},
-        {VK_F13, "F13"}, {VK_F14, "F14"}, {VK_F15, "F15"}, {VK_F16, "F16"},
-        {VK_F17, "F17"}, {VK_F18, "F18"}, {VK_F19, "F19"}, {VK_F20, "F20"},
-        {VK_F21, "F21"}, {VK_F22, "F22"}, {VK_F23, "F23"}, {VK_F24, "F24"}
-    };
+    static constexpr VkTable table{VK_CAT_FUNC_NUM};
     return table;
 }
 
 // 支持度高的基础按键分表
 const VkTable& highFuncVkTables() {
-    static VkTable table = {
-        {VK_BACK, "Back"}, {VK_TAB, "Tab"}, {VK_RETURN, "Enter"}, {VK_CAPITAL, "CapsLock"},
-        {VK_ESCAPE, "Escape"}, {VK_SPACE, "Space"}, {VK_PRIOR, "PageUp"}, {VK_NEXT, "PageDown"},
-        {VK_END, "End"}, {VK_HOME, "Home"}, {VK_INSERT, "Insert"}, {VK_DELETE, "Delete"}
-    };
+    static constexpr VkTable table{VK_CAT_HIGH_FUNC};
     return table;
 }
 
 // 支持度中的基础按键分表
 const VkTable& midFuncVkTables() {
-    static VkTable table = {
-        {VK_CLEAR, "Clear"}, {VK_PAUSE, "Pause"}, {VK_SELECT, "Select"}, {VK_PRINT, "Print"},
-        {VK_EXECUTE, "Execute"}, {VK_SNAPSHOT, "Snapshot"}, {VK_HELP, "Help"},
-        {VK_NUMLOCK, "NumLock"}, {VK_SCROLL, "ScrollLock"}
-    };
+    static constexpr VkTable table{VK_CAT_MID_FUNC};
     return table;
 }
 
 // 非常重要的修饰键分表
 const VkTable& modifyVkTables() {
-    static VkTable table = {
-        {VK_LWIN, "LWin"}, {VK_RWIN, "RWin"}, {VK_APPS, "Apps"},
-        {VK_MENU, "Alt"},{VK_LMENU, "LAlt"}, {VK_RMENU, "RAlt"},
-        {VK_SHIFT, "Shift"}, {VK_LSHIFT, "LShift"}, {VK_RSHIFT, "RShift"},
-        {VK_CONTROL, "Ctrl"}, {VK_LCONTROL, "LCtrl"}, {VK_RCONTROL, "RCtrl"}
-    };
+    static constexpr VkTable table{VK_CAT_MODIFY};
     return table;
 }
 
 // 浏览器控制键分表
 const VkTable& browserVkTables() {
-    static VkTable table = {
-        {VK_BROWSER_BACK, "BrowserBack"}, {VK_BROWSER_FORWARD, "BrowserForward"},
-        {VK_BROWSER_REFRESH, "BrowserRefresh"}, {VK_BROWSER_STOP, "BrowserStop"},
-        {VK_BROWSER_SEARCH, "BrowserSearch"}, {VK_BROWSER_FAVORITES, "BrowserFavorites"},
-        {VK_BROWSER_HOME, "BrowserHome"}
-    };
+    static constexpr VkTable table{VK_CAT_BROWSER};
     return table;
 }
 
 // 多媒体控制键分表
 const VkTable& appVkTables() {
-    static VkTable table = {
-        {VK_VOLUME_MUTE, "VolumeMute"}, {VK_VOLUME_DOWN, "VolumeDown"}, {VK_VOLUME_UP, "VolumeUp"},
-        {VK_MEDIA_NEXT_TRACK, "MediaNext"}, {VK_MEDIA_PREV_TRACK, "MediaPrev"},
-        {VK_MEDIA_STOP, "MediaStop"}, {VK_MEDIA_PLAY_PAUSE, "MediaPlayPause"},
-        {VK_LAUNCH_MAIL, "LaunchMail"}, {VK_LAUNCH_MEDIA_SELECT, "LaunchMedia"},
-        {VK_LAUNCH_APP1, "LaunchApp1"}, {VK_LAUNCH_APP2, "LaunchApp2"}
-    };
+    static constexpr VkTable table{VK_CAT_APP};
     return table;
 }
 
 // 常用标点符号键分表
 const VkTable& interVkTables() {
-    static VkTable table = {
-        {VK_OEM_1, ";:"}, {VK_OEM_PLUS, "+="}, {VK_OEM_COMMA, ",<"},
-        {VK_OEM_MINUS, "-_"}, {VK_OEM_PERIOD, ".>"}, {VK_OEM_2, "/?"}, {VK_OEM_3, "`~"},
-        {VK_OEM_4, "[{"}, {VK_OEM_5, "\\|"}, {VK_OEM_6, "]}"},
-        {VK_OEM_7, "'\""}, {VK_OEM_8, "MiscChar"}
-    };
+    static constexpr VkTable table{VK_CAT_INTER};
     return table;
 }
 
 // 其余杂项虚拟键分表
 const VkTable& otherVkTables() {
-    static VkTable table = {
-        {VK_SLEEP, "Sleep"}, {VK_OEM_102, "RT102"},
-        {VK_PROCESSKEY, "ProcessKey"}, {VK_PACKET, "Packet"},
-        {VK_ATTN, "Attn"}, {VK_CRSEL, "CrSel"}, {VK_EXSEL, "ExSel"},
-        {VK_EREOF, "EraseEOF"}, {VK_PLAY, "Play"}, {VK_ZOOM, "Zoom"},
-        {VK_NONAME, "NoName"}, {VK_PA1, "PA1"}, {VK_OEM_CLEAR, "OEMClear"}
-    };
+    static constexpr VkTable table{VK_CAT_OTHER};
     return table;
 }
 
-// 分表组合
+// 分表组合（分类掩码取并集）
 VkTable combineVkTables(const std::vector<const VkTable*>& tables) {
-    VkTable result;
+    VkTable result{0};
     for (auto t : tables) {
-        result.insert(t->begin(), t->end());
+        result.mask |= t->mask;
     }
     return result;
 }
 
 // 主接口
-std::string vkCodeToString(int vkCode, const VkTable& table) {
-    auto it = table.find(vkCode);
-    if (it != table.end()) return it->second;
-    return "VK(" + std::to_string(vkCode) + ")";
+std::string_view vkCodeToString(int vkCode, const VkTable& table) {
+    std::string_view name = table.name(vkCode);
+    if (!name.empty()) return name;
+    return fallbackName(vkCode);
+}
+
+// 反向查找
+int vkCodeFromString(std::string_view name) {
+    if (name.empty()) return -1;
+    for (int vk = 0; vk < 256; ++vk) {
+        if (kVkNames[vk] == name) return vk;
+    }
+    if (name.size() == 1) {
+        char ch = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+        for (int vk = 0; vk < 256; ++vk) {
+            if (kVkNames[vk].size() == 2 && kVkNames[vk][0] == ch) return vk;
+        }
+        for (int vk = 0; vk < 256; ++vk) {
+            if (kVkNames[vk].size() == 1 && kVkNames[vk][0] == ch) return vk;
+        }
+    }
+    return -1;
+}
+
+// 修饰键组合位
+uint32_t vkModifierBits(const KeyState& pressed) {
+    uint32_t bits = 0;
+    if (pressed.test(VK_CONTROL) || pressed.test(VK_LCONTROL) || pressed.test(VK_RCONTROL)) bits |= VK_MOD_CTRL;
+    if (pressed.test(VK_MENU) || pressed.test(VK_LMENU) || pressed.test(VK_RMENU)) bits |= VK_MOD_ALT;
+    if (pressed.test(VK_SHIFT) || pressed.test(VK_LSHIFT) || pressed.test(VK_RSHIFT)) bits |= VK_MOD_SHIFT;
+    if (pressed.test(VK_LWIN) || pressed.test(VK_RWIN)) bits |= VK_MOD_WIN;
+    return bits;
 }
@@ -1,12 +1,44 @@
 #pragma once
 
-#include <map>
-#include <string>
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
 #include "json.hpp"
+#include "key_state.h"
 
-using VkTable = std::map<int, std::string>;
+// VK分类标记（每个VK码属于一个或多个分表）
+enum VkCategory : uint32_t {
+    VK_CAT_MOUSE       = 1u << 0,
+    VK_CAT_IME         = 1u << 1,
+    VK_CAT_DIRECTION   = 1u << 2,
+    VK_CAT_MAIN_NUM    = 1u << 3,
+    VK_CAT_ALPHABET    = 1u << 4,
+    VK_CAT_LITE_NUM    = 1u << 5,
+    VK_CAT_LITE_NUM_OP = 1u << 6,
+    VK_CAT_FUNC_NUM    = 1u << 7,
+    VK_CAT_HIGH_FUNC   = 1u << 8,
+    VK_CAT_MID_FUNC    = 1u << 9,
+    VK_CAT_MODIFY      = 1u << 10,
+    VK_CAT_BROWSER     = 1u << 11,
+    VK_CAT_APP         = 1u << 12,
+    VK_CAT_INTER       = 1u << 13,
+    VK_CAT_OTHER       = 1u << 14,
+    VK_CAT_ALL         = (1u << 15) - 1
+};
+
+// 映射表：编译期生成的256项名称表按分类掩码筛选，查找为一次下标访问
+struct VkTable {
+    uint32_t mask = VK_CAT_ALL;
+
+    // VK码是否属于本表
+    [[nodiscard]] bool contains(int vkCode) const;
+    // 本表中的名称，不在表中时返回空
+    [[nodiscard]] std::string_view name(int vkCode) const;
+};
+
+// VK码所属分类（不在任何分表中时为0）
+uint32_t vkCategory(int vkCode);
 
 // 获取主映射表
 const VkTable& getMainVkTable();
@@ -31,8 +63,23 @@ const VkTable& otherVkTables();
 // 组合分表
 VkTable combineVkTables(const std::vector<const VkTable*>& tables);
 
-// 主接口：根据vkCode和映射表获取字符串
-std::string vkCodeToString(int vkCode, const VkTable& table = getMainVkTable());
+// 主接口：根据vkCode和映射表获取字符串（不在表中时返回"VK(n)"，均指向静态存储）
+std::string_view vkCodeToString(int vkCode, const VkTable& table = getMainVkTable());
+
+// 反向查找：名称 → VK码（在全部分类中查找，单字符时也匹配双符号名的首字符，如 "1" → "1!"；未找到返回-1）
+int vkCodeFromString(std::string_view name);
+
+// 修饰键组合位
+enum VkModifier : uint32_t {
+    VK_MOD_CTRL  = 1u << 0,
+    VK_MOD_ALT   = 1u << 1,
+    VK_MOD_SHIFT = 1u << 2,
+    VK_MOD_WIN   = 1u << 3,
+    VK_MOD_COUNT = 1u << 4
+};
+
+// 当前按下的修饰键组合（左右键与通用键等价）
+uint32_t vkModifierBits(const KeyState& pressed);
 
 // 初始化主映射表（从json配置），main.cpp只需调用一次
 void initVkMainTableFromJson(const nlohmann::json& config);
@@ -3,25 +3,20 @@
 #include <windows.h>
 
 #include "spine_animation.h"
+#include "window_physics.h"
 
 // 物理参数
 constexpr float HORIZ_DECAY = 0.85f;    // 水平速度衰减系数
-constexpr float DT_LIMIT = 0.05f;       // 最大dt，防止卡顿穿透
-constexpr float TOP_BOUNCE_GRAVITY = 2.0f; // 顶部反弹加速度倍数
-
-struct WindowPhysicsState {
-    float vx = 0.0f;
-    float vy = 0.0f;
-    float lastX = 0.0f;
-    float lastY = 0.0f;
-    bool isDragging = false;
-    bool locked = false;
-};
-
-struct WindowWorkArea {
-    int minX, maxX, minY, maxY;
-    int width, height;
-};
+constexpr float DT_LIMIT = 0.25f;       // 最大dt，避免长时间挂起后一次性跳变
+constexpr float REST_SPEED = 1.0f;      // 低于该速度(px/s)视为静止
+
+// 全局物理状态（定义在 main.cpp）
+extern WindowPhysicsState g_windowPhysicsState;
+
+// 休眠唤醒
+void wakeWindowPhysics() {
+    g_windowPhysicsState.sleeping = false;
+}
 
 // 步行状态
 static bool walkEnabled = true;
@@ -29,6 +24,7 @@ static int walkDirection = 1; // 1=右，-1=左
 
 void setWalkEnabled(bool enabled) {
     walkEnabled = enabled;
+    wakeWindowPhysics();
 }
 
 // 方向翻转接口实现
@@ -48,17 +44,34 @@ int getWalkDirection() {
 static bool gravityEnabled = true;
 void setGravityEnabled(bool enabled) {
     gravityEnabled = enabled;
+    wakeWindowPhysics();
 }
 bool isGravityEnabled() {
     return gravityEnabled;
 }
 
+// 位置锁定
+void setPositionLocked(bool locked) {
+    setWalkEnabled(!locked);
+    setGravityEnabled(!locked);
+    g_windowPhysicsState.locked = locked;
+    if (!locked) {
+        g_windowPhysicsState.vx = 0.0f;
+        g_windowPhysicsState.vy = 0.0f;
+        wakeWindowPhysics();
+    }
+}
+bool isPositionLocked() {
+    return g_windowPhysicsState.locked;
+}
+
 // 外部声明，需加上类型声明头文件
 extern SpineAnimation* animSystem;
 
 void updateWindowPhysics(HWND hwnd, WindowPhysicsState& state, const WindowWorkArea& area, float speed, float gravity, float dt) {
     if (state.isDragging) return; // 拖动时不应用物理
     if (state.locked) return; // 锁定时不应用速度和位置更新
+    if (state.sleeping) return; // 静止休眠时等待事件唤醒
 
     dt = std::min(dt, DT_LIMIT);
 
@@ -68,58 +81,38 @@ void updateWindowPhysics(HWND hwnd, WindowPhysicsState& state, const WindowWorkA
     auto x = static_cast<float>(rc.left);
     auto y = static_cast<float>(rc.top);
 
-    // 应用重力（可开关）
-    if (isGravityEnabled()) {
-        state.vy += gravity * dt;
-    }
-
     // 步行逻辑：只有接触底边且不在拖动状态且开启步行且动画为Move时
     extern SpineAnimation* animSystem;
     bool isMoveAnim = animSystem && animSystem->getCurrentAnimation() == "Move";
-    if (walkEnabled && isMoveAnim && std::abs(y - static_cast<float>(area.maxY)) < 0.5f) {
+    bool walking = walkEnabled && isMoveAnim;
+    if (walking && std::abs(y - static_cast<float>(area.maxY)) < 0.5f) {
         state.vx = speed * static_cast<float>(walkDirection);
     }
 
-    // 位置更新
-    x += state.vx * dt;
-    y += state.vy * dt;
-
-    // 边界检测与反弹
-    bool hitLeft = false, hitRight = false, hitBottom = false, hitTop = false;
-
-    if (x < static_cast<float>(area.minX)) {
-        x = static_cast<float>(area.minX);
-        hitLeft = true;
-    }
-    if (x > static_cast<float>(area.maxX)) {
-        x = static_cast<float>(area.maxX);
-        hitRight = true;
-    }
-    if (y > static_cast<float>(area.maxY)) {
-        y = static_cast<float>(area.maxY);
-        state.vy = 0.0f;
-        hitBottom = true;
-    }
-    if (y < static_cast<float>(area.minY)) {
-        state.vy += gravity * TOP_BOUNCE_GRAVITY * dt;
-        state.vx *= HORIZ_DECAY;
-        y = static_cast<float>(area.minY);
-        hitTop = true;
-    }
+    // 位置更新与边界碰撞
+    WindowContacts contacts = stepWindowPhysics(x, y, state, area, isGravityEnabled() ? gravity : 0.0f, dt);
 
     // 步行到边界时自动反向
-    if (walkEnabled && hitLeft && walkDirection == -1 && animSystem) {
+    if (walkEnabled && contacts.left && walkDirection == -1 && animSystem) {
         animSystem->setFlip(true, false);
         walkDirection = 1;
     }
-    if (walkEnabled && hitRight && walkDirection == 1 && animSystem) {
+    if (walkEnabled && contacts.right && walkDirection == 1 && animSystem) {
         animSystem->setFlip(true, false);
         walkDirection = -1;
     }
 
-    // 水平速度衰减
-    if (hitTop || hitBottom) { state.vx *= HORIZ_DECAY; }
-    if (hitLeft || hitRight) { state.vx = 0.0f; }
+    // 水平速度衰减（每帧一次，与子步数无关）
+    if (contacts.top || contacts.bottom) { state.vx *= HORIZ_DECAY; }
+
+    // 静止检测：贴底（或无重力）且速度归零且不在步行时进入休眠
+    bool onFloor = contacts.bottom || std::abs(y - static_cast<float>(area.maxY)) < 0.5f;
+    if (!walking && (onFloor || !isGravityEnabled()) &&
+        std::abs(state.vx) < REST_SPEED && std::abs(state.vy) < REST_SPEED) {
+        state.vx = 0.0f;
+        state.vy = 0.0f;
+        state.sleeping = true;
+    }
 
     // 应用新位置
     SetWindowPos(hwnd, nullptr,
@@ -2,25 +2,18 @@
 
 #include <Windows.h>
 
-// 物理状态
-struct WindowPhysicsState {
-    float vx = 0.0f;
-    float vy = 0.0f;
-    float lastX = 0.0f;
-    float lastY = 0.0f;
-    bool isDragging = false;
-    bool locked = false;
-};
-
-// 工作区信息
-struct WindowWorkArea {
-    int minX, maxX, minY, maxY;
-    int width, height;
-};
+#include "physics_step.h"
 
 // 物理更新
 void updateWindowPhysics(HWND hwnd, WindowPhysicsState& state, const WindowWorkArea& area, float speed, float gravity, float dt);
 
+// 休眠唤醒（拖动、工作区变化、锁定切换、重力切换、Move动画开始时调用）
+void wakeWindowPhysics();
+
+// 位置锁定（停止行走和重力，解锁时清零速度）
+void setPositionLocked(bool locked);
+bool isPositionLocked();
+
 // 重力开关
 void setGravityEnabled(bool enabled);
 bool isGravityEnabled();